@@ -10,7 +10,8 @@ if "%debug%"=="1" set release=0 && echo [debug mode]
 if "%release%"=="1" set debug=0 && echo [release mode]
 
 :: --- Unpack Command line Build Arguments ------------------------------------
-:: None for now...
+set pack_flags=
+if "%pack_compress%"=="1" set pack_flags=-c
 
 :: --- Compile/Link Definitions -----------------------------------------------
 set cl_common=/nologo /EHsc /std:c++17 ^
@@ -24,11 +25,29 @@ if "%debug%"=="1" set cl_compile=%cl_debug%
 if "%release%"=="1" set cl_compile=%cl_release%
 if "%debug%"=="1" set cl_link=%cl_link_debug%
 if "%release%"=="1" set cl_link=%cl_link_release%
+if "%alloc_tracker%"=="1" set cl_compile=%cl_compile% /DBUILD_ALLOC_TRACKER
 
 :: --- Shader Compile Definitions ---------------------------------------------
+:: Every shader as <stage>:<file name>, in resource id order. Adding a shader only needs an entry here.
+:: A shader with permutation axes (see resources.cpp) lists them after another ':', separated by '+'.
+set shaders=vertex:fullscreen fragment:placeholder fragment:fbm_warp:FBM_LOW_OCTAVES fragment:fbm_warp_texture:FBM_LOW_OCTAVES fragment:fbm_warp_cached:FBM_LOW_OCTAVES fragment:plasma_beat fragment:upscale_easu fragment:sharpen_rcas fragment:checkerboard_resolve fragment:checkerboard_error fragment:fbm_warp_field compute:fbm_warp_compute:FBM_LOW_OCTAVES compute:plasma_beat_compute
 set shadercross=call ..\extern\SDL3_shadercross\win\bin\shadercross.exe
-set shadercross_vertex=%shadercross% -t vertex -DVERTEX_SHADER
-set shadercross_fragment=%shadercross% -t fragment -DFRAGMENT_SHADER
+set shadercross_vertex=%shadercross% -I ..\src -t vertex -DVERTEX_SHADER
+set shadercross_fragment=%shadercross% -I ..\src -t fragment -DFRAGMENT_SHADER
+set shadercross_compute=%shadercross% -I ..\src -t compute -DCOMPUTE_SHADER
+:: Every texture generated at startup (see noise_texture.cpp), given resource ids after the shaders.
+set textures=noise_lattice
+set gen_inputs=
+for %%s in (%shaders%) do (
+for /f "tokens=1,2,3 delims=:" %%a in ("%%s") do (
+if "%%c"=="" (
+set gen_inputs=!gen_inputs! %%a:..\src\%%b.hlsl
+) else (
+set gen_inputs=!gen_inputs! %%a:..\src\%%b.hlsl:%%c
+)
+)
+)
+for %%t in (%textures%) do set gen_inputs=!gen_inputs! texture:%%t
 
 :: --- Prep Directories -------------------------------------------------------
 set build_dir_debug=build_debug
@@ -41,11 +60,29 @@ if not exist %build_dir%\res mkdir %build_dir%\res
 :: --- Build Everything -------------------------------------------------------
 pushd %build_dir%
 
+echo Generating resource info...
+%cl_release% /I..\extern\SDL3_shadercross\win\include ..\src\gen_resources.cpp /link ..\extern\SDL3_shadercross\win\lib\SDL3_shadercross.lib %cl_link_common% /out:gen_resources.exe || exit /b 1
+set "PATH=%PATH%;%CD%\..\extern\SDL3\win\lib\x64;%CD%\..\extern\SDL3_shadercross\win\bin"
+gen_resources.exe -o ..\src\resources_info.cpp -v shader_variants.txt %gen_inputs% || exit /b 1
+
 if "%release%"=="1" (
+rem Every variant of every shader, as listed by gen_resources.
 echo Compiling shaders...
-%shadercross_vertex% ..\src\fullscreen.hlsl -o res\fullscreen.dxil || exit /b 1
-%shadercross_fragment% ..\src\fbm_warp.hlsl -o res\fbm_warp.dxil || exit /b 1
-%shadercross_fragment% ..\src\plasma_beat.hlsl -o res\plasma_beat.dxil || exit /b 1
+set pack_inputs=
+for /f "usebackq tokens=1,2,3,*" %%a in ("shader_variants.txt") do (
+!shadercross_%%a! %%d ..\src\%%b.hlsl -o res\%%c.dxil || exit /b 1
+set pack_inputs=!pack_inputs! res\%%c.dxil
+)
+
+echo Packing resources...
+%cl_release% ..\src\pack_resources.cpp /link %cl_link_common% /out:pack_resources.exe || exit /b 1
+copy ..\extern\SDL3\win\lib\x64\SDL3.dll . >nul
+pack_resources.exe %pack_flags% -o res\resources.pak !pack_inputs! || exit /b 1
+)
+
+if "%read_bench%"=="1" (
+echo Compiling read benchmark...
+%cl_release% ..\src\read_bench.cpp /link %cl_link_common% /out:read_bench.exe || exit /b 1
 )
 
 echo Compiling source files...
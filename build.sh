@@ -45,7 +45,16 @@ if [ $debug -eq 1 ]; then release=0 && echo "[debug mode]"; fi
 if [ $release -eq 1 ]; then debug=0 && echo "[release mode]"; fi
 
 # --- Unpack Command line Build Arguments ------------------------------------
-# None for now...
+pack_compress=0
+read_bench=0
+alloc_tracker=0
+for arg in "$@"; do
+  if [ "$arg" == "pack_compress" ]; then pack_compress=1; fi
+  if [ "$arg" == "read_bench" ]; then read_bench=1; fi
+  if [ "$arg" == "alloc_tracker" ]; then alloc_tracker=1; fi
+done
+pack_flags=""
+if [ $pack_compress -eq 1 ]; then pack_flags="-c"; fi
 
 # --- Compile/Link Definitions -----------------------------------------------
 cc_common="-std=c++17 \
@@ -60,11 +69,30 @@ if [ $debug -eq 1 ]; then cc_compile="$cc_debug"; fi
 if [ $release -eq 1 ]; then cc_compile="$cc_release"; fi
 if [ $debug -eq 1 ]; then cc_link="$cc_link_debug"; fi
 if [ $release -eq 1 ]; then cc_link="$cc_link_release"; fi
+if [ $alloc_tracker -eq 1 ]; then cc_compile="$cc_compile -DBUILD_ALLOC_TRACKER"; fi
 
 # --- Shader Compile Definitions ---------------------------------------------
+# Every shader as <stage>:<file name>, in resource id order. Adding a shader only needs an entry here.
+# A shader with permutation axes (see resources.cpp) lists them after another ':', separated by '+'.
+shaders="vertex:fullscreen fragment:placeholder fragment:fbm_warp:FBM_LOW_OCTAVES fragment:fbm_warp_texture:FBM_LOW_OCTAVES fragment:fbm_warp_cached:FBM_LOW_OCTAVES fragment:plasma_beat fragment:upscale_easu fragment:sharpen_rcas fragment:checkerboard_resolve fragment:checkerboard_error fragment:fbm_warp_field compute:fbm_warp_compute:FBM_LOW_OCTAVES compute:plasma_beat_compute"
 shadercross="../extern/SDL3_shadercross/linux/bin/shadercross"
-shadercross_vertex="$shadercross -t vertex -DVERTEX_SHADER"
-shadercross_fragment="$shadercross -t fragment -DFRAGMENT_SHADER"
+shadercross_vertex="$shadercross -I ../src -t vertex -DVERTEX_SHADER"
+shadercross_fragment="$shadercross -I ../src -t fragment -DFRAGMENT_SHADER"
+shadercross_compute="$shadercross -I ../src -t compute -DCOMPUTE_SHADER"
+# Every texture generated at startup (see noise_texture.cpp), given resource ids after the shaders.
+textures="noise_lattice"
+gen_inputs=""
+for shader in $shaders; do
+  shader_stage="${shader%%:*}"
+  shader_name="${shader#*:}"
+  shader_axes=""
+  if [[ "$shader_name" == *:* ]]; then
+    shader_axes=":${shader_name#*:}"
+    shader_name="${shader_name%%:*}"
+  fi
+  gen_inputs="$gen_inputs $shader_stage:../src/$shader_name.hlsl$shader_axes"
+done
+for texture in $textures; do gen_inputs="$gen_inputs texture:$texture"; done
 
 # --- Prep Directories -------------------------------------------------------
 build_dir_debug="build_debug"
@@ -77,11 +105,31 @@ mkdir -p "$build_dir/res"
 # --- Build Everything -------------------------------------------------------
 pushd "$build_dir" >/dev/null
 
+echo "Generating resource info..."
+$cc_release -I../extern/SDL3_shadercross/linux/include ../src/gen_resources.cpp \
+  -L../extern/SDL3_shadercross/linux/lib -lSDL3_shadercross $cc_link_common -o gen_resources || exit 1
+LD_LIBRARY_PATH=../extern/SDL3/linux/lib:../extern/SDL3_shadercross/linux/lib \
+  ./gen_resources -o ../src/resources_info.cpp -v shader_variants.txt $gen_inputs || exit 1
+
 if [ $release -eq 1 ]; then
+  # Every variant of every shader, as listed by gen_resources.
   echo "Compiling shaders..."
-  $shadercross_vertex ../src/fullscreen.hlsl -o res/fullscreen.spv || exit 1
-  $shadercross_fragment ../src/fbm_warp.hlsl -o res/fbm_warp.spv || exit 1
-  $shadercross_fragment ../src/plasma_beat.hlsl -o res/plasma_beat.spv || exit 1
+  pack_inputs=""
+  while read -r stage name variant_name defines; do
+    shadercross_stage="shadercross_${stage}"
+    ${!shadercross_stage} $defines ../src/${name}.hlsl -o res/${variant_name}.spv || exit 1
+    pack_inputs="$pack_inputs res/${variant_name}.spv"
+  done < shader_variants.txt
+
+  echo "Packing resources..."
+  $cc_release ../src/pack_resources.cpp $cc_link_release -o pack_resources || exit 1
+  LD_LIBRARY_PATH=../extern/SDL3/linux/lib ./pack_resources $pack_flags -o res/resources.pak \
+    $pack_inputs || exit 1
+fi
+
+if [ $read_bench -eq 1 ]; then
+  echo "Compiling read benchmark..."
+  $cc_release ../src/read_bench.cpp $cc_link_common -o read_bench || exit 1
 fi
 
 echo "Compiling source files..."
@@ -0,0 +1,178 @@
+// -- Allocation Tracker ------------------------------------------------------
+//
+// Opt-in (BUILD_ALLOC_TRACKER) counting of heap allocations, used to check that the frame loop
+// doesn't allocate once it has warmed up. Global operator new, SDL's memory functions and ImGui's
+// allocator are all routed through counting wrappers. An allocation is only counted when the
+// thread making it has entered a phase, which in practice means the main thread inside
+// SDL_AppIterate; worker threads compiling shaders or creating pipelines are never attributed.
+// Without the build flag every function here is a no-op.
+
+enum Alloc_Phase {
+  ALLOC_PHASE_NONE,
+  ALLOC_PHASE_UPDATE,  // Everything in a frame not covered by the phases below.
+  ALLOC_PHASE_LIVE_RELOAD,
+  ALLOC_PHASE_IMGUI_BUILD,
+  ALLOC_PHASE_COMMAND_RECORDING,
+  ALLOC_PHASE_SUBMIT,
+  ALLOC_PHASE_COUNT,
+};
+
+static constexpr std::array<const char*, ALLOC_PHASE_COUNT> ALLOC_PHASE_NAMES = {
+    "none",
+    "update",
+    "live reload",
+    "imgui build",
+    "command recording",
+    "submit",
+};
+
+struct Alloc_Stats {
+  std::array<uint64_t, ALLOC_PHASE_COUNT> counts;
+  std::array<uint64_t, ALLOC_PHASE_COUNT> bytes;
+};
+
+static uint64_t alloc_stats_total_count(const Alloc_Stats& stats) {
+  uint64_t total = 0;
+  for (auto count : stats.counts) { total += count; }
+
+  return total;
+}
+
+#ifdef BUILD_ALLOC_TRACKER
+static thread_local Alloc_Phase alloc_tracker_phase = ALLOC_PHASE_NONE;
+
+// Only written by threads that are in a phase, i.e. the main thread.
+static Alloc_Stats alloc_tracker_stats;
+
+static SDL_malloc_func  alloc_tracker_sdl_malloc;
+static SDL_calloc_func  alloc_tracker_sdl_calloc;
+static SDL_realloc_func alloc_tracker_sdl_realloc;
+static SDL_free_func    alloc_tracker_sdl_free;
+
+static void alloc_tracker_count(size_t size) {
+  if (alloc_tracker_phase == ALLOC_PHASE_NONE) { return; }
+  alloc_tracker_stats.counts[alloc_tracker_phase] += 1;
+  alloc_tracker_stats.bytes[alloc_tracker_phase] += size;
+}
+
+static void* SDLCALL alloc_tracker_sdl_malloc_hook(size_t size) {
+  alloc_tracker_count(size);
+  return alloc_tracker_sdl_malloc(size);
+}
+
+static void* SDLCALL alloc_tracker_sdl_calloc_hook(size_t count, size_t size) {
+  alloc_tracker_count(count * size);
+  return alloc_tracker_sdl_calloc(count, size);
+}
+
+static void* SDLCALL alloc_tracker_sdl_realloc_hook(void* ptr, size_t size) {
+  alloc_tracker_count(size);
+  return alloc_tracker_sdl_realloc(ptr, size);
+}
+
+static void SDLCALL alloc_tracker_sdl_free_hook(void* ptr) {
+  alloc_tracker_sdl_free(ptr);
+}
+
+static void* alloc_tracker_imgui_alloc(size_t size, void*) {
+  alloc_tracker_count(size);
+  return std::malloc(size);
+}
+
+static void alloc_tracker_imgui_free(void* ptr, void*) {
+  std::free(ptr);
+}
+
+// Call before anything else. The hooks forward to the original allocators, so memory allocated
+// before they were installed can still be freed through them.
+static bool alloc_tracker_init() {
+  SDL_GetOriginalMemoryFunctions(
+      &alloc_tracker_sdl_malloc,
+      &alloc_tracker_sdl_calloc,
+      &alloc_tracker_sdl_realloc,
+      &alloc_tracker_sdl_free);
+  if (!SDL_SetMemoryFunctions(
+          alloc_tracker_sdl_malloc_hook,
+          alloc_tracker_sdl_calloc_hook,
+          alloc_tracker_sdl_realloc_hook,
+          alloc_tracker_sdl_free_hook)) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to set SDL memory functions: %s",
+        SDL_GetError());
+    return false;
+  }
+  ImGui::SetAllocatorFunctions(alloc_tracker_imgui_alloc, alloc_tracker_imgui_free);
+
+  return true;
+}
+
+static void alloc_tracker_set_phase(Alloc_Phase phase) {
+  alloc_tracker_phase = phase;
+}
+
+// Returns what has been counted since the previous call.
+static Alloc_Stats alloc_tracker_take_stats() {
+  auto stats          = alloc_tracker_stats;
+  alloc_tracker_stats = {};
+
+  return stats;
+}
+
+// Over-aligned new isn't replaced, nothing in the tree uses it.
+void* operator new(size_t size) {
+  alloc_tracker_count(size);
+  auto ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) { throw std::bad_alloc(); }
+
+  return ptr;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  alloc_tracker_count(size);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+  return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+  std::free(ptr);
+}
+#else
+static bool alloc_tracker_init() {
+  return true;
+}
+
+static void alloc_tracker_set_phase(Alloc_Phase) {
+}
+
+static Alloc_Stats alloc_tracker_take_stats() {
+  return {};
+}
+#endif
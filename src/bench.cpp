@@ -0,0 +1,223 @@
+// -- Benchmark ---------------------------------------------------------------
+//
+// Bookkeeping for --bench: every shader kind is run on each of its paths (fragment, and compute if
+// it has a compute version) at every render scale (a "case"), first for a number of warm up frames
+// and then for a number of measured frames, with the shader time driven by a fixed step rather
+// than the wall clock so that runs are comparable. The results are written as JSON or CSV, picked
+// by the extension of the output path.
+
+static constexpr int    BENCH_WARMUP_FRAMES   = 60;
+static constexpr int    BENCH_MEASURED_FRAMES = 300;
+static constexpr double BENCH_TIME_STEP       = 1.0 / 60.0;
+
+struct Bench_Stats {
+  double min;
+  double mean;
+  double p50;
+  double p95;
+  double p99;
+};
+
+struct Bench_Result {
+  const char* shader_name;
+  const char* path;  // "fragment" or "compute".
+  float       render_scale;
+  int         width;
+  int         height;
+  int         frames_count;
+  Bench_Stats cpu_ms;
+  Bench_Stats gpu_ms;
+};
+
+struct Bench {
+  const char*               output_path;
+  int                       measured_frames;
+  int                       case_index;
+  int                       case_frame;  // Counts the warm up frames too.
+  std::vector<float>        cpu_ms;      // Of the measured frames of the current case.
+  std::vector<float>        gpu_ms;
+  std::vector<Bench_Result> results;
+};
+
+// Sorts the samples.
+static Bench_Stats bench_stats(std::vector<float>* samples) {
+  Bench_Stats stats = {};
+  if (samples->empty()) { return stats; }
+
+  std::sort(samples->begin(), samples->end());
+  double sum = 0.0;
+  for (auto sample : *samples) { sum += sample; }
+
+  // Nearest rank percentiles.
+  auto percentile = [&](double p) {
+    auto rank = static_cast<size_t>(SDL_ceil(p / 100.0 * static_cast<double>(samples->size())));
+    return static_cast<double>((*samples)[SDL_clamp(rank, size_t(1), samples->size()) - 1]);
+  };
+  stats.min  = samples->front();
+  stats.mean = sum / static_cast<double>(samples->size());
+  stats.p50  = percentile(50.0);
+  stats.p95  = percentile(95.0);
+  stats.p99  = percentile(99.0);
+
+  return stats;
+}
+
+static void bench_init(Bench* bench, const char* output_path, int measured_frames) {
+  SDL_assert(bench != nullptr);
+  SDL_assert(output_path != nullptr);
+
+  bench->output_path     = output_path;
+  bench->measured_frames = measured_frames > 0 ? measured_frames : BENCH_MEASURED_FRAMES;
+  bench->cpu_ms.reserve(bench->measured_frames);
+  bench->gpu_ms.reserve(bench->measured_frames);
+}
+
+static bool bench_is_measuring(const Bench& bench) {
+  return bench.case_frame >= BENCH_WARMUP_FRAMES;
+}
+
+static void bench_add_sample(Bench* bench, float cpu_ms, float gpu_ms) {
+  SDL_assert(bench != nullptr);
+
+  bench->cpu_ms.push_back(cpu_ms);
+  bench->gpu_ms.push_back(gpu_ms);
+}
+
+// Returns true once the current case has run all of its frames.
+static bool bench_end_frame(Bench* bench) {
+  SDL_assert(bench != nullptr);
+
+  bench->case_frame += 1;
+  return bench->case_frame >= BENCH_WARMUP_FRAMES + bench->measured_frames;
+}
+
+static void bench_end_case(
+    Bench*      bench,
+    const char* shader_name,
+    const char* path,
+    float       render_scale,
+    int         width,
+    int         height) {
+  SDL_assert(bench != nullptr);
+
+  Bench_Result result = {};
+  result.shader_name  = shader_name;
+  result.path         = path;
+  result.render_scale = render_scale;
+  result.width        = width;
+  result.height       = height;
+  result.frames_count = static_cast<int>(bench->cpu_ms.size());
+  result.cpu_ms       = bench_stats(&bench->cpu_ms);
+  result.gpu_ms       = bench_stats(&bench->gpu_ms);
+  bench->results.push_back(result);
+
+  SDL_LogInfo(
+      SDL_LOG_CATEGORY_APPLICATION,
+      "Bench %s (%s) at %dx%d: cpu p50 %.3f ms, gpu p50 %.3f ms, gpu p99 %.3f ms",
+      shader_name,
+      path,
+      width,
+      height,
+      result.cpu_ms.p50,
+      result.gpu_ms.p50,
+      result.gpu_ms.p99);
+
+  bench->cpu_ms.clear();
+  bench->gpu_ms.clear();
+  bench->case_index += 1;
+  bench->case_frame  = 0;
+}
+
+static void bench_write_json_stats(SDL_IOStream* io, const char* name, const Bench_Stats& stats) {
+  SDL_IOprintf(
+      io,
+      "\"%s\": {\"min\": %.4f, \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f}",
+      name,
+      stats.min,
+      stats.mean,
+      stats.p50,
+      stats.p95,
+      stats.p99);
+}
+
+static bool bench_write_report(const Bench& bench, const char* driver_name) {
+  auto io = SDL_IOFromFile(bench.output_path, "w");
+  if (io == nullptr) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to open %s: %s",
+        bench.output_path,
+        SDL_GetError());
+    return false;
+  }
+
+  auto extension = SDL_strrchr(bench.output_path, '.');
+  if (extension != nullptr && SDL_strcasecmp(extension, ".csv") == 0) {
+    SDL_IOprintf(
+        io,
+        "shader,path,render_scale,width,height,frames,"
+        "cpu_min_ms,cpu_mean_ms,cpu_p50_ms,cpu_p95_ms,cpu_p99_ms,"
+        "gpu_min_ms,gpu_mean_ms,gpu_p50_ms,gpu_p95_ms,gpu_p99_ms\n");
+    for (const auto& result : bench.results) {
+      const auto& cpu = result.cpu_ms;
+      const auto& gpu = result.gpu_ms;
+      SDL_IOprintf(
+          io,
+          "%s,%s,%.2f,%d,%d,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+          result.shader_name,
+          result.path,
+          result.render_scale,
+          result.width,
+          result.height,
+          result.frames_count,
+          cpu.min,
+          cpu.mean,
+          cpu.p50,
+          cpu.p95,
+          cpu.p99,
+          gpu.min,
+          gpu.mean,
+          gpu.p50,
+          gpu.p95,
+          gpu.p99);
+    }
+  } else {
+    SDL_IOprintf(io, "{\n");
+    SDL_IOprintf(io, "  \"driver\": \"%s\",\n", driver_name);
+    SDL_IOprintf(io, "  \"warmup_frames\": %d,\n", BENCH_WARMUP_FRAMES);
+    SDL_IOprintf(io, "  \"measured_frames\": %d,\n", bench.measured_frames);
+    SDL_IOprintf(io, "  \"time_step\": %.6f,\n", BENCH_TIME_STEP);
+    SDL_IOprintf(io, "  \"results\": [\n");
+    for (size_t i = 0; i < bench.results.size(); i++) {
+      const auto& result = bench.results[i];
+      SDL_IOprintf(
+          io,
+          "    {\"shader\": \"%s\", \"path\": \"%s\", \"render_scale\": %.2f, \"width\": %d, "
+          "\"height\": %d, \"frames\": %d, ",
+          result.shader_name,
+          result.path,
+          result.render_scale,
+          result.width,
+          result.height,
+          result.frames_count);
+      bench_write_json_stats(io, "cpu_ms", result.cpu_ms);
+      SDL_IOprintf(io, ", ");
+      bench_write_json_stats(io, "gpu_ms", result.gpu_ms);
+      SDL_IOprintf(io, "}%s\n", i + 1 < bench.results.size() ? "," : "");
+    }
+    SDL_IOprintf(io, "  ]\n");
+    SDL_IOprintf(io, "}\n");
+  }
+
+  if (!SDL_CloseIO(io)) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to write %s: %s",
+        bench.output_path,
+        SDL_GetError());
+    return false;
+  }
+  SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Wrote benchmark report %s", bench.output_path);
+
+  return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// Shared by the checkerboard passes. Every texture they read is the same size, and only its top
+// left render_size region is used.
+cbuffer Checkerboard_Uniforms : register(b0, space3) {
+  float2 texture_size : packoffset(c0);
+  float2 render_size : packoffset(c0.z);
+  float  parity : packoffset(c1);           // Of the frame, as in common.hlsl.
+  float  history_valid : packoffset(c1.y);  // 1 when the history holds the previous frame.
+};
+
+Texture2D<float4> texture0 : register(t0, space2);
+SamplerState      sampler0 : register(s0, space2);
+Texture2D<float4> texture1 : register(t1, space2);
+SamplerState      sampler1 : register(s1, space2);
+
+// Expects a point sampler.
+float3 load_texel(Texture2D<float4> t, SamplerState s, int2 p) {
+  float2 uv = (float2(p) + 0.5) / texture_size;
+  return t.SampleLevel(s, uv, 0.0).rgb;
+}
@@ -0,0 +1,19 @@
+// Visualises the error of the checkerboard reconstruction (texture0) against the same frame with
+// every pixel shaded (texture1): a dimmed grey copy of the frame, tinted red where they differ.
+
+#include "checkerboard_common.hlsl"
+
+static const float ERROR_GAIN = 8.0;
+
+float4 main(float2 tex_coord : TEXCOORD0) : SV_Target {
+  int2   p             = int2(tex_coord * render_size);
+  float3 reconstructed = load_texel(texture0, sampler0, p);
+  float3 reference     = load_texel(texture1, sampler1, p);
+
+  float3 diff  = abs(reconstructed - reference);
+  float  error = saturate(max(diff.r, max(diff.g, diff.b)) * ERROR_GAIN);
+  float  grey  = dot(reference, float3(0.2126, 0.7152, 0.0722)) * 0.25;
+  float3 color = lerp(float3(grey, grey, grey), float3(1.0, 0.05, 0.05), error);
+
+  return float4(color, 1.0);
+}
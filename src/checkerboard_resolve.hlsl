@@ -0,0 +1,40 @@
+// Reconstructs the full frame from the half of its pixels shaded this frame (texture0, packed two
+// pixels per texel) and the reconstruction of the previous frame (texture1). The missing pixels
+// come from the history, clamped to the range of their four shaded neighbours so that moving
+// content doesn't leave trails, or from the average of those neighbours when there's no history.
+
+#include "checkerboard_common.hlsl"
+
+bool is_shaded(int2 p) {
+  return ((p.x + p.y + int(parity)) & 1) == 0;
+}
+
+// Reads a shaded pixel. Out of range neighbours are mirrored, which keeps them shaded.
+float3 load_field(int2 p) {
+  int2 last = int2(render_size) - 1;
+  p         = last - abs(last - abs(p));
+  p         = clamp(p, int2(0, 0), last);
+  return load_texel(texture0, sampler0, int2(p.x >> 1, p.y));
+}
+
+float4 main(float2 tex_coord : TEXCOORD0) : SV_Target {
+  int2 p = int2(tex_coord * render_size);
+  if (is_shaded(p)) { return float4(load_field(p), 1.0); }
+
+  float3 l = load_field(p + int2(-1, 0));
+  float3 r = load_field(p + int2(1, 0));
+  float3 u = load_field(p + int2(0, -1));
+  float3 d = load_field(p + int2(0, 1));
+
+  float3 color;
+  if (history_valid > 0.0) {
+    float3 min4    = min(min(l, r), min(u, d));
+    float3 max4    = max(max(l, r), max(u, d));
+    float3 history = load_texel(texture1, sampler1, p);
+    color          = clamp(history, min4, max4);
+  } else {
+    color = (l + r + u + d) * 0.25;
+  }
+
+  return float4(color, 1.0);
+}
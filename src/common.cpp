@@ -18,8 +18,156 @@ template<typename F> Priv_Defer<F> defer_func(F f) {
 #define DEFER_3(x)    DEFER_2(x, __COUNTER__)
 #define defer(code)   auto DEFER_3(_defer_) = defer_func([&]() { code; })
 
+// -- Arena -------------------------------------------------------------------
+//
+// A bump allocator made of a chain of blocks. Memory handed out by an arena is not initialised and
+// is released all at once by arena_reset or arena_destroy. Arenas are not thread safe; give each
+// thread (or job) its own.
+
+static constexpr size_t ARENA_DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+struct Arena_Block {
+  Arena_Block* prev;
+  size_t       capacity;
+  size_t       used;
+};
+
+struct Arena {
+  Arena_Block* current    = nullptr;
+  size_t       block_size = ARENA_DEFAULT_BLOCK_SIZE;
+};
+
+static void* arena_push(Arena* arena, size_t size, size_t alignment = 16) {
+  SDL_assert(arena != nullptr);
+  SDL_assert((alignment & (alignment - 1)) == 0);
+
+  // Aligns the address rather than the offset, the header leaves the data of a block only 8 byte
+  // aligned.
+  auto block = arena->current;
+  if (block != nullptr) {
+    auto base    = reinterpret_cast<uintptr_t>(block + 1);
+    auto address = (base + block->used + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    auto offset  = address - base;
+    if (offset + size <= block->capacity) {
+      block->used = offset + size;
+      return reinterpret_cast<void*>(address);
+    }
+  }
+
+  // Blocks are never resized, so large requests get a block of their own.
+  auto capacity = SDL_max(arena->block_size, size + alignment);
+  auto new_block =
+      static_cast<Arena_Block*>(SDL_aligned_alloc(64, sizeof(Arena_Block) + capacity));
+  if (new_block == nullptr) { return nullptr; }
+  new_block->prev     = block;
+  new_block->capacity = capacity;
+  new_block->used     = 0;
+  arena->current      = new_block;
+
+  return arena_push(arena, size, alignment);
+}
+
+// Frees every block but the first, which is kept around so that steady state use of an arena
+// doesn't allocate.
+static void arena_reset(Arena* arena) {
+  SDL_assert(arena != nullptr);
+
+  auto block = arena->current;
+  while (block != nullptr && block->prev != nullptr) {
+    auto prev = block->prev;
+    SDL_aligned_free(block);
+    block = prev;
+  }
+  if (block != nullptr) { block->used = 0; }
+  arena->current = block;
+}
+
+// Where an arena is at, to rewind it to when what was pushed since isn't needed after all.
+struct Arena_Mark {
+  Arena_Block* block;
+  size_t       used;
+};
+
+static Arena_Mark arena_mark(const Arena& arena) {
+  return {arena.current, arena.current != nullptr ? arena.current->used : 0};
+}
+
+// Frees the blocks added since the mark.
+static void arena_rewind(Arena* arena, Arena_Mark mark) {
+  SDL_assert(arena != nullptr);
+
+  while (arena->current != mark.block) {
+    auto prev = arena->current->prev;
+    SDL_aligned_free(arena->current);
+    arena->current = prev;
+  }
+  if (arena->current != nullptr) { arena->current->used = mark.used; }
+}
+
+static void arena_destroy(Arena* arena) {
+  SDL_assert(arena != nullptr);
+
+  arena_reset(arena);
+  SDL_aligned_free(arena->current);
+  arena->current = nullptr;
+}
+
+// Unlike arena_push the array is zero filled.
+template<typename T> T* arena_push_array(Arena* arena, size_t count) {
+  auto data = static_cast<T*>(arena_push(arena, count * sizeof(T), alignof(T)));
+  if (data != nullptr) { SDL_memset(data, 0, count * sizeof(T)); }
+  return data;
+}
+
+// STL compatible allocator that allocates from an arena, so that standard containers can hold
+// transient data. Deallocation is a no-op: the memory comes back when the arena is reset, which
+// must not happen while a container still points into it. Containers that grow leave their old
+// buffers behind, so reserve up front where the size is known. A default constructed allocator
+// has no arena; move assign a container built with a real one before using it.
+template<typename T> struct Arena_Allocator {
+  typedef T              value_type;
+  typedef std::true_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  Arena* arena = nullptr;
+
+  Arena_Allocator() = default;
+  Arena_Allocator(Arena* arena) : arena(arena) {
+  }
+  template<typename U> Arena_Allocator(const Arena_Allocator<U>& other) : arena(other.arena) {
+  }
+
+  T* allocate(size_t count) {
+    SDL_assert(arena != nullptr);
+    auto data = arena_push(arena, count * sizeof(T), alignof(T));
+    if (data == nullptr) { throw std::bad_alloc(); }
+    return static_cast<T*>(data);
+  }
+
+  void deallocate(T*, size_t) {}
+};
+
+template<typename T, typename U>
+bool operator==(const Arena_Allocator<T>& a, const Arena_Allocator<U>& b) {
+  return a.arena == b.arena;
+}
+
+template<typename T, typename U>
+bool operator!=(const Arena_Allocator<T>& a, const Arena_Allocator<U>& b) {
+  return a.arena != b.arena;
+}
+
+template<typename T> using Arena_Vector = std::vector<T, Arena_Allocator<T>>;
+typedef std::basic_string<char, std::char_traits<char>, Arena_Allocator<char>> Arena_String;
+
 // -- Storage -----------------------------------------------------------------
 
+struct Byte_Span {
+  const uint8_t* data;
+  size_t         size;
+};
+
 template<typename Container>
 bool read_storage_file(SDL_Storage* storage, const char* file_path, Container* out_container) {
   Uint64 file_size = 0;
@@ -43,3 +191,173 @@ bool read_storage_file(SDL_Storage* storage, const char* file_path, Container* o
 
   return true;
 }
+
+// Reads a whole file into memory pushed onto the arena. Unlike the container version above the
+// memory isn't zero filled before being read into, and nothing is allocated once the arena has
+// warmed up.
+static bool read_storage_file(
+    SDL_Storage* storage,
+    const char*  file_path,
+    Arena*       arena,
+    Byte_Span*   out_span) {
+  Uint64 file_size = 0;
+  if (!SDL_GetStorageFileSize(storage, file_path, &file_size)) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to get storage file size: %s",
+        SDL_GetError());
+    return false;
+  }
+  if (file_size == 0) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to get storage file size: file size is 0");
+    return false;
+  }
+
+  auto mark = arena_mark(*arena);
+  auto data = static_cast<uint8_t*>(arena_push(arena, file_size));
+  if (data == nullptr) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to allocate %" SDL_PRIu64 " bytes",
+        file_size);
+    return false;
+  }
+  if (!SDL_ReadStorageFile(storage, file_path, data, file_size)) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to read storage file: %s", SDL_GetError());
+    arena_rewind(arena, mark);
+    return false;
+  }
+
+  out_span->data = data;
+  out_span->size = file_size;
+
+  return true;
+}
+
+// -- Hashing -----------------------------------------------------------------
+
+static constexpr uint64_t HASH_SEED = 0xcbf29ce484222325ull;
+
+// 64-bit FNV-1a. Pass the result of a previous call as the seed to hash several values together.
+static uint64_t hash_bytes(const void* data, size_t size, uint64_t seed = HASH_SEED) {
+  auto     bytes = static_cast<const uint8_t*>(data);
+  uint64_t hash  = seed;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ull;
+  }
+
+  return hash;
+}
+
+static uint64_t hash_string(const char* str, uint64_t seed = HASH_SEED) {
+  return hash_bytes(str, SDL_strlen(str), seed);
+}
+
+// -- Memory Mapped Files -----------------------------------------------------
+
+struct Mapped_File {
+  const uint8_t* data;
+  size_t         size;
+#ifdef SDL_PLATFORM_WINDOWS
+  HANDLE file_handle;
+  HANDLE mapping_handle;
+#endif
+};
+
+// Maps a whole file read-only. The mapping stays valid until unmap_file is called.
+static bool map_file(const char* file_path, Mapped_File* out_file) {
+  SDL_assert(file_path != nullptr);
+  SDL_assert(out_file != nullptr);
+
+  *out_file = {};
+#ifdef SDL_PLATFORM_WINDOWS
+  wchar_t wide_path[MAX_PATH];
+  if (MultiByteToWideChar(CP_UTF8, 0, file_path, -1, wide_path, MAX_PATH) == 0) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to convert path: %s", file_path);
+    return false;
+  }
+  out_file->file_handle = CreateFileW(
+      wide_path,
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+  if (out_file->file_handle == INVALID_HANDLE_VALUE) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to open file: %s", file_path);
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(out_file->file_handle, &file_size) || file_size.QuadPart == 0) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to get file size: %s", file_path);
+    CloseHandle(out_file->file_handle);
+    return false;
+  }
+  out_file->size = static_cast<size_t>(file_size.QuadPart);
+
+  out_file->mapping_handle =
+      CreateFileMappingW(out_file->file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (out_file->mapping_handle == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create file mapping: %s", file_path);
+    CloseHandle(out_file->file_handle);
+    return false;
+  }
+
+  out_file->data =
+      static_cast<const uint8_t*>(MapViewOfFile(out_file->mapping_handle, FILE_MAP_READ, 0, 0, 0));
+  if (out_file->data == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to map view of file: %s", file_path);
+    CloseHandle(out_file->mapping_handle);
+    CloseHandle(out_file->file_handle);
+    return false;
+  }
+#else
+  int fd = open(file_path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to open file %s: %s",
+        file_path,
+        strerror(errno));
+    return false;
+  }
+  defer(close(fd));
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to get file size: %s", file_path);
+    return false;
+  }
+  out_file->size = static_cast<size_t>(file_stat.st_size);
+
+  auto data = mmap(nullptr, out_file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to map file %s: %s",
+        file_path,
+        strerror(errno));
+    return false;
+  }
+  out_file->data = static_cast<const uint8_t*>(data);
+#endif
+
+  return true;
+}
+
+static void unmap_file(Mapped_File* file) {
+  SDL_assert(file != nullptr);
+
+  if (file->data == nullptr) { return; }
+#ifdef SDL_PLATFORM_WINDOWS
+  UnmapViewOfFile(file->data);
+  CloseHandle(file->mapping_handle);
+  CloseHandle(file->file_handle);
+#else
+  munmap(const_cast<uint8_t*>(file->data), file->size);
+#endif
+  *file = {};
+}
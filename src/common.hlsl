@@ -0,0 +1,44 @@
+#pragma once
+
+// SDL GPU puts the uniform buffers of fragment shaders in space3, and those of compute shaders in
+// space2.
+#ifdef COMPUTE_SHADER
+#define UNIFORM_SPACE space2
+#else
+#define UNIFORM_SPACE space3
+#endif
+
+cbuffer Uniform_Block : register(b0, UNIFORM_SPACE) {
+  float  time : packoffset(c0);
+  float2 resolution : packoffset(c0.y);
+  float  checkerboard : packoffset(c0.w);  // The frame parity when checkerboarding, else -1.
+};
+
+// The pixel a fragment shades. When checkerboarding the viewport is half as wide, and each of its
+// pixels stands for one of a horizontal pair, picked by the row and the frame parity so that the
+// shaded pixels form a checkerboard that flips every frame.
+float2 get_frag_coord(float2 tex_coord) {
+  if (checkerboard < 0.0) { return tex_coord * resolution; }
+
+  float2 field_coord = floor(tex_coord * float2(ceil(resolution.x * 0.5), resolution.y));
+  float  offset      = fmod(field_coord.y + checkerboard, 2.0);
+  return float2(field_coord.x * 2.0 + offset, field_coord.y) + 0.5;
+}
+
+float mod(float x, float y) {
+  return x - y * floor(x / y);
+}
+
+float3 mod(float3 x, float y) {
+  return x - y * floor(x / y);
+}
+
+// https://www.shadertoy.com/view/4dS3Wd
+// By Morgan McGuire @morgan3d, http://graphicscodex.com
+float hash(float n) {
+  return frac(sin(n) * 1e4);
+}
+
+float hash(float2 p) {
+  return frac(1e4 * sin(17.0 * p.x + p.y * 0.1) * (0.1 + abs(sin(p.y * 13.0 + p.x))));
+}
@@ -0,0 +1,62 @@
+// -- Dynamic Resolution ------------------------------------------------------
+//
+// Adjusts the render scale to keep the frame time within a budget. The frame time is smoothed, and
+// the scale only moves once the smoothed time has left a band around the budget, after which it is
+// held for a short cooldown so that the effect of a change shows up before the next one. Scaling
+// down is proportional to the overshoot (shading cost goes with the pixel count, so the square root
+// of the ratio), scaling up is a small fixed step, so the scale drops quickly when a frame gets
+// expensive and recovers carefully.
+//
+// The input is the interval between frames, which covers both the CPU and the GPU, less the time
+// spent waiting for the display to take the next frame. Otherwise, with VSync on, the interval
+// couldn't drop below the refresh interval and the scale would never recover.
+
+static constexpr float  DYNAMIC_RESOLUTION_MIN_SCALE     = 0.25f;
+static constexpr float  DYNAMIC_RESOLUTION_MAX_SCALE     = 1.0f;
+static constexpr float  DYNAMIC_RESOLUTION_UPPER_BAND    = 1.05f;  // Of the budget.
+static constexpr float  DYNAMIC_RESOLUTION_LOWER_BAND    = 0.80f;
+static constexpr float  DYNAMIC_RESOLUTION_MAX_STEP_DOWN = 0.85f;  // Scale multiplier.
+static constexpr float  DYNAMIC_RESOLUTION_STEP_UP       = 0.05f;
+static constexpr float  DYNAMIC_RESOLUTION_SMOOTHING     = 0.1f;
+static constexpr double DYNAMIC_RESOLUTION_COOLDOWN      = 0.25;  // Seconds.
+
+static constexpr std::array DYNAMIC_RESOLUTION_BUDGETS_MS = {16.6f, 8.3f};
+
+struct Dynamic_Resolution {
+  bool   enabled;
+  int    budget_index;  // Into DYNAMIC_RESOLUTION_BUDGETS_MS.
+  float  scale = DYNAMIC_RESOLUTION_MAX_SCALE;
+  float  smoothed_frame_ms;
+  double cooldown;
+};
+
+// Returns true when the scale changed.
+static bool dynamic_resolution_update(Dynamic_Resolution* dr, double frame_seconds) {
+  SDL_assert(dr != nullptr);
+
+  auto frame_ms = static_cast<float>(frame_seconds * 1000.0);
+  if (dr->smoothed_frame_ms <= 0.0f) { dr->smoothed_frame_ms = frame_ms; }
+  dr->smoothed_frame_ms += (frame_ms - dr->smoothed_frame_ms) * DYNAMIC_RESOLUTION_SMOOTHING;
+
+  if (!dr->enabled) { return false; }
+  if (dr->cooldown > 0.0) {
+    dr->cooldown -= frame_seconds;
+    return false;
+  }
+
+  auto budget_ms = DYNAMIC_RESOLUTION_BUDGETS_MS[dr->budget_index];
+  auto scale     = dr->scale;
+  if (dr->smoothed_frame_ms > budget_ms * DYNAMIC_RESOLUTION_UPPER_BAND) {
+    auto step = SDL_sqrtf(budget_ms / dr->smoothed_frame_ms);
+    scale *= SDL_max(step, DYNAMIC_RESOLUTION_MAX_STEP_DOWN);
+  } else if (dr->smoothed_frame_ms < budget_ms * DYNAMIC_RESOLUTION_LOWER_BAND) {
+    scale += DYNAMIC_RESOLUTION_STEP_UP;
+  }
+  scale = SDL_clamp(scale, DYNAMIC_RESOLUTION_MIN_SCALE, DYNAMIC_RESOLUTION_MAX_SCALE);
+  if (scale == dr->scale) { return false; }
+
+  dr->scale    = scale;
+  dr->cooldown = DYNAMIC_RESOLUTION_COOLDOWN;
+
+  return true;
+}
@@ -0,0 +1,44 @@
+// fbm_warp.hlsl with the first level of the warp (q), and optionally the second (r), bilinearly
+// sampled from a field rendered at a fraction of the resolution (fbm_warp_field.hlsl). Both levels
+// vary slowly across the frame, so this costs little accuracy and leaves only the final fbm (and
+// those of r, when it isn't cached) to evaluate per pixel.
+
+#include "fbm_warp_field_common.hlsl"
+
+// Consecutive keyframes of the field, blended by field_blend. The same texture twice when the
+// field isn't cached across frames.
+Texture2D<float4> warp_field0 : register(t0, space2);
+SamplerState      warp_field_sampler0 : register(s0, space2);  // Linear.
+Texture2D<float4> warp_field1 : register(t1, space2);
+SamplerState      warp_field_sampler1 : register(s1, space2);
+
+static const float ERROR_GAIN = 8.0;
+
+float4 main(float2 tex_coord : TEXCOORD0) : SV_Target {
+  float2 frag_coord = get_frag_coord(tex_coord);
+  float2 p          = pattern_point(frag_coord);
+
+  // Kept half a texel inside of the field, so that filtering never reads past its edge.
+  float2 field_coord = clamp(frag_coord / resolution * field_size, 0.5, field_size - 0.5);
+  float2 field_uv    = field_coord / field_texture_size;
+  float4 field       = warp_field0.SampleLevel(warp_field_sampler0, field_uv, 0.0);
+  if (field_blend > 0.0) {
+    field = lerp(field, warp_field1.SampleLevel(warp_field_sampler1, field_uv, 0.0), field_blend);
+  }
+  float2 q     = field.xy;
+  float2 r     = cache_r > 0.0 ? field.zw : pattern_r(p, q);
+  float4 color = shade(frag_coord, pattern_f(p, r), q, r);
+  if (show_error <= 0.0) { return color; }
+
+  // As in checkerboard_error.hlsl, a dimmed grey copy of the exact frame tinted red where they
+  // differ.
+  float2 exact_q = pattern_q(p);
+  float2 exact_r;
+  float  exact_f   = pattern_warp(p, exact_q, exact_r);
+  float3 reference = shade(frag_coord, exact_f, exact_q, exact_r).rgb;
+
+  float3 diff  = abs(color.rgb - reference);
+  float  error = saturate(max(diff.r, max(diff.g, diff.b)) * ERROR_GAIN);
+  float  grey  = dot(reference, float3(0.2126, 0.7152, 0.0722)) * 0.25;
+  return float4(lerp(float3(grey, grey, grey), float3(1.0, 0.05, 0.05), error), 1.0);
+}
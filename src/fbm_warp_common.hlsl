@@ -0,0 +1,139 @@
+#pragma once
+
+// The fbm domain warp shared by the fragment (fbm_warp.hlsl) and compute (fbm_warp_compute.hlsl)
+// versions. Defining NOISE_TEXTURE reads the noise lattice from a texture instead of hashing it.
+// FBM_LOW_OCTAVES is a permutation axis of the shaders that include this, which trades the finest
+// octave of every fbm for speed.
+
+#include "common.hlsl"
+
+#ifdef FBM_LOW_OCTAVES
+static const int FBM_OCTAVES = 3;
+#else
+static const int FBM_OCTAVES = 4;
+#endif
+
+static const float2 FLOW_DIR = float2(1.0, 0.3);
+static const float2 Q_OFFSET = float2(5.2, 1.3);
+
+#ifdef NOISE_TEXTURE
+// The hash() of every point of a tile of the lattice, generated at startup (noise_texture.cpp) and
+// sampled with wrapping.
+static const float NOISE_LATTICE_SIZE = 256.0;
+
+Texture2D<float> noise_lattice : register(t0, space2);
+SamplerState     noise_lattice_sampler : register(s0, space2);
+#endif
+
+float noise(float2 x) {
+  float2 i = floor(x);
+  float2 f = frac(x);
+
+#ifdef NOISE_TEXTURE
+  // Gathering at the corner shared by the texels i and i + 1 fetches the four lattice values of the
+  // cell at once, as (i + (0, 1), i + (1, 1), i + (1, 0), i).
+  float4 h = noise_lattice.Gather(noise_lattice_sampler, (i + 1.0) / NOISE_LATTICE_SIZE);
+  float  a = h.w;
+  float  b = h.z;
+  float  c = h.x;
+  float  d = h.y;
+#else
+  float a = hash(i);
+  float b = hash(i + float2(1.0, 0.0));
+  float c = hash(i + float2(0.0, 1.0));
+  float d = hash(i + float2(1.0, 1.0));
+#endif
+
+  float2 u = f * f * (3.0 - 2.0 * f);
+  return lerp(a, b, u.x) + (c - a) * u.y * (1.0 - u.x) + (d - b) * u.x * u.y;
+}
+
+float fbm(float2 x, float H) {
+  float G = exp2(-H);
+  float f = 1.0;
+  float a = 1.0;
+  float t = 0.0;
+  for (int i = 0; i < FBM_OCTAVES; i++) {
+    t += a * noise(f * x);
+    f *= 2.0;
+    a *= G;
+  }
+
+  return t;
+}
+
+// The point the pattern is evaluated at for a pixel, scrolling over time.
+float2 pattern_point(float2 frag_coord) {
+  float2 p = float2(frag_coord - 0.5 * resolution);
+  p        = 4.0 * p / resolution.y;
+
+  float2 scroll =
+      float2(time * 0.01 + sin(time * 0.05) * 1.5, time * 0.025 + cos(time * 0.07) * 1.5);
+
+  return p + scroll;
+}
+
+// The first level of the warp is q = (fbm(x), fbm(x + Q_OFFSET)) of the x returned here. Unlike
+// the rest of the pattern it is affine in the pixel position, which the compute version relies on.
+float2 pattern_q_point(float2 p) {
+  float pulse = 1.0 + sin(time * 0.2) * 0.1;
+  return p * pulse;
+}
+
+float2 pattern_q(float2 p) {
+  float2 q_point = pattern_q_point(p);
+  return float2(fbm(q_point, 5.0), fbm(q_point + Q_OFFSET, 5.0));
+}
+
+// The second level of the warp, from the first.
+float2 pattern_r(float2 p, float2 q) {
+  float flow_speed = time * 0.16;
+  return float2(
+      fbm(p + 4.0 * q + float2(1.7, 9.2) + FLOW_DIR * flow_speed, 5.0),
+      fbm(p + 4.0 * q + float2(8.3, 2.8) - FLOW_DIR * flow_speed * 0.7, 5));
+}
+
+// The pattern itself, from the second level of the warp.
+float pattern_f(float2 p, float2 r) {
+  return fbm(p + 4.0 * r + time * 0.01, 7);
+}
+
+// The rest of the warp, from the first level.
+float pattern_warp(float2 p, float2 q, out float2 r) {
+  r = pattern_r(p, q);
+  return pattern_f(p, r);
+}
+
+float4 shade(float2 frag_coord, float f, float2 q, float2 r) {
+  float3 normal = normalize(float3((q.x - 0.5) * 2.0, (r.y - 0.5) * 2.0, 1.0));
+
+  float q_len = length(q) * 0.5;
+  float r_len = length(r) * 0.5;
+
+  static const float3 col1 = float3(0.1, 0.0, 0.0);
+  static const float3 col2 = float3(0.6, 0.1, 0.0);
+  static const float3 col3 = float3(1.0, 0.4, 0.0);
+  static const float3 col4 = float3(0.968, 0.965, 0.923);
+
+  float3 color = lerp(col1, col2, smoothstep(0.0, 0.4, f));
+  color        = lerp(color, col3, smoothstep(0.3, 0.8, f));
+  color        = lerp(color, col4, smoothstep(0.8, 1.0, f));
+  color        = lerp(color, color * 1.3, smoothstep(0.3, 0.8, q_len));
+  color        = lerp(color, col2, smoothstep(0.6, 1.0, r_len) * 0.3);
+
+  float3 light_dir = normalize(float3(0.5, 0.8, 1.2));
+  float  diffuse   = max(dot(normal, light_dir), 0.0);
+  float  lighting  = 0.33 + diffuse * 0.8;
+
+  color *= lighting;
+  color = pow(color, float3(2.2, 2.2, 2.2));
+
+  static const float VIGNETTE_RADIUS   = 1.9;
+  static const float VIGNETTE_SOFTNESS = 0.85;
+  float2             uv                = (frag_coord - 0.5 * resolution) / (resolution.y * 0.5);
+  float              dist              = length(uv);
+  float vignette = smoothstep(VIGNETTE_RADIUS, VIGNETTE_RADIUS - VIGNETTE_SOFTNESS, dist);
+  color *= vignette;
+
+  return float4(color, 1.0);
+}
@@ -0,0 +1,114 @@
+// Compute version of fbm_warp.hlsl, one pixel per thread in 8x8 tiles.
+//
+// The two fbms of the first warp level are sampled at points that are affine in the pixel
+// position, so the pixels of a tile only ever touch a few lattice points of each of their octaves.
+// Their lattice hashes are computed once per tile into group shared memory rather than four times
+// per noise call per pixel. When a tile covers too many lattice points to cache (very low render
+// resolutions) that octave falls back to hashing directly. The warped fbms after that sample
+// unrelated points for neighbouring pixels, and hash as usual.
+
+#include "fbm_warp_common.hlsl"
+
+static const int TILE_SIZE          = 8;
+static const int LATTICE_CACHE_DIM  = 4;
+static const int LATTICE_CACHE_SIZE = LATTICE_CACHE_DIM * LATTICE_CACHE_DIM;
+static const int LATTICES_COUNT     = 2 * FBM_OCTAVES;  // Both first level fbms, every octave.
+
+[[vk::image_format("rgba8")]]
+RWTexture2D<float4> output_texture : register(u0, space1);
+
+groupshared float lattice_hashes[LATTICES_COUNT * LATTICE_CACHE_SIZE];
+
+// The lattice point with the lowest coordinates touched by a tile, whose first and last pixels
+// sample the first level fbms at q_first and q_last. Sets cached when every lattice point the tile
+// touches fits in the cache.
+int2 lattice_origin(int lattice, float2 q_first, float2 q_last, out bool cached) {
+  float  f      = exp2(float(lattice % FBM_OCTAVES));
+  float2 offset = lattice < FBM_OCTAVES ? float2(0.0, 0.0) : Q_OFFSET;
+  // The same expressions as fbm evaluates, so the floors agree with the ones of every pixel.
+  int2 first = int2(floor(f * (q_first + offset)));
+  int2 last  = int2(floor(f * (q_last + offset))) + 1;
+  cached     = all(last - first < LATTICE_CACHE_DIM);
+  return first;
+}
+
+float cached_hash(int lattice, int2 origin, float2 i) {
+  // Clamped in case rounding puts a pixel a hair outside of the lattice points of its tile.
+  int2 c = clamp(int2(i) - origin, 0, LATTICE_CACHE_DIM - 1);
+  return lattice_hashes[lattice * LATTICE_CACHE_SIZE + c.y * LATTICE_CACHE_DIM + c.x];
+}
+
+// noise() with the hashes read from the cache of the lattice.
+float cached_noise(float2 x, int lattice, int2 origin) {
+  float2 i = floor(x);
+  float2 f = frac(x);
+
+  float a = cached_hash(lattice, origin, i);
+  float b = cached_hash(lattice, origin, i + float2(1.0, 0.0));
+  float c = cached_hash(lattice, origin, i + float2(0.0, 1.0));
+  float d = cached_hash(lattice, origin, i + float2(1.0, 1.0));
+
+  float2 u = f * f * (3.0 - 2.0 * f);
+  return lerp(a, b, u.x) + (c - a) * u.y * (1.0 - u.x) + (d - b) * u.x * u.y;
+}
+
+// fbm() of one of the first level fbms, first_lattice being that of its first octave.
+float cached_fbm(
+    float2 x,
+    float  H,
+    int    first_lattice,
+    int2   origins[LATTICES_COUNT],
+    bool   cached[LATTICES_COUNT]) {
+  float G = exp2(-H);
+  float f = 1.0;
+  float a = 1.0;
+  float t = 0.0;
+  [unroll] for (int i = 0; i < FBM_OCTAVES; i++) {
+    int lattice = first_lattice + i;
+    if (cached[lattice]) {
+      t += a * cached_noise(f * x, lattice, origins[lattice]);
+    } else {
+      t += a * noise(f * x);
+    }
+    f *= 2.0;
+    a *= G;
+  }
+
+  return t;
+}
+
+[numthreads(TILE_SIZE, TILE_SIZE, 1)]
+void main(uint3 id : SV_DispatchThreadID, uint3 group_id : SV_GroupID, uint index : SV_GroupIndex) {
+  float2 tile_first = float2(group_id.xy * TILE_SIZE) + 0.5;
+  float2 q_first    = pattern_q_point(pattern_point(tile_first));
+  float2 q_last     = pattern_q_point(pattern_point(tile_first + float(TILE_SIZE - 1)));
+
+  int2 origins[LATTICES_COUNT];
+  bool cached[LATTICES_COUNT];
+  [unroll] for (int lattice = 0; lattice < LATTICES_COUNT; lattice++) {
+    origins[lattice] = lattice_origin(lattice, q_first, q_last, cached[lattice]);
+  }
+
+  for (uint e = index; e < LATTICES_COUNT * LATTICE_CACHE_SIZE; e += TILE_SIZE * TILE_SIZE) {
+    int  lattice      = e / LATTICE_CACHE_SIZE;
+    int  cell         = e % LATTICE_CACHE_SIZE;
+    int2 point        = origins[lattice] + int2(cell % LATTICE_CACHE_DIM, cell / LATTICE_CACHE_DIM);
+    lattice_hashes[e] = hash(float2(point));
+  }
+  GroupMemoryBarrierWithGroupSync();
+
+  // Only after the barrier, which every thread of the group has to reach.
+  if (any(id.xy >= uint2(resolution))) { return; }
+
+  float2 frag_coord = float2(id.xy) + 0.5;
+  float2 p          = pattern_point(frag_coord);
+  float2 q_point    = pattern_q_point(p);
+  float2 q          = float2(
+      cached_fbm(q_point, 5.0, 0, origins, cached),
+      cached_fbm(q_point + Q_OFFSET, 5.0, FBM_OCTAVES, origins, cached));
+
+  float2 r;
+  float  f = pattern_warp(p, q, r);
+
+  output_texture[id.xy] = shade(frag_coord, f, q, r);
+}
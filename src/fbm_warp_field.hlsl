@@ -0,0 +1,13 @@
+// The first level (q) of the fbm_warp domain warp, and the second (r) if cached, at a fraction of
+// the render resolution for fbm_warp_cached.hlsl. resolution is that of the frame and the viewport
+// is the field's, so every texel holds the warp at the point of the frame at its centre.
+
+#include "fbm_warp_field_common.hlsl"
+
+float4 main(float2 tex_coord : TEXCOORD0) : SV_Target {
+  float2 p = pattern_point(tex_coord * resolution);
+  float2 q = pattern_q(p);
+  float2 r = cache_r > 0.0 ? pattern_r(p, q) : float2(0.0, 0.0);
+
+  return float4(q, r);
+}
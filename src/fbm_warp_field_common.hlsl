@@ -0,0 +1,14 @@
+#pragma once
+
+// Shared by the warp field prepass (fbm_warp_field.hlsl) and the fbm_warp version that samples it
+// (fbm_warp_cached.hlsl). The field is rendered to the top left field_size region of its texture.
+
+#include "fbm_warp_common.hlsl"
+
+cbuffer Warp_Field_Uniforms : register(b1, UNIFORM_SPACE) {
+  float2 field_size : packoffset(c0);
+  float2 field_texture_size : packoffset(c0.z);
+  float  cache_r : packoffset(c1);        // 1 when the field holds r as well as q, else 0.
+  float  show_error : packoffset(c1.y);   // 1 to draw the error against fbm_warp.hlsl instead.
+  float  field_blend : packoffset(c1.z);  // Between the two fields, see warp_field_cache.cpp.
+};
@@ -0,0 +1,5 @@
+// fbm_warp.hlsl with the noise lattice read from the generated noise_lattice texture rather than
+// hashed. Selectable next to fbm_warp to compare the two.
+
+#define NOISE_TEXTURE
+#include "fbm_warp.hlsl"
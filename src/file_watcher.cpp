@@ -0,0 +1,263 @@
+// -- File Watcher ------------------------------------------------------------
+//
+// Watches a set of files on a background thread and hands the ids of changed files to the main
+// thread through a single-producer/single-consumer lock-free queue. On Linux inotify is used so
+// that changes are reported as soon as the editor closes the file. Everywhere else (or if inotify
+// can't be initialised) the watcher falls back to polling the modify time of each file.
+
+static constexpr int    FILE_WATCHER_MAX_FILES        = 64;
+static constexpr int    FILE_WATCHER_QUEUE_CAPACITY   = 256;
+static constexpr Uint32 FILE_WATCHER_POLL_INTERVAL_MS = 100;
+
+static_assert(
+    (FILE_WATCHER_QUEUE_CAPACITY & (FILE_WATCHER_QUEUE_CAPACITY - 1)) == 0,
+    "File watcher queue capacity must be a power of two");
+
+struct File_Watcher_Queue {
+  std::array<int, FILE_WATCHER_QUEUE_CAPACITY> items;
+  SDL_AtomicInt                                head;  // Only written by the consumer.
+  SDL_AtomicInt                                tail;  // Only written by the producer.
+  SDL_AtomicInt                                overflowed;
+};
+
+struct File_Watcher_File {
+  int         id;
+  std::string file_path;
+  std::string full_path;  // Prefixed with the base path, so polling doesn't build strings.
+  SDL_Time    last_modify_time;
+#ifdef SDL_PLATFORM_LINUX
+  int         watch_descriptor;
+  const char* file_name;
+#endif
+};
+
+struct File_Watcher {
+  std::string                                            base_path;
+  SDL_Thread*                                            thread;
+  SDL_AtomicInt                                          quit;
+  SDL_Mutex*                                             files_mutex;
+  std::array<File_Watcher_File, FILE_WATCHER_MAX_FILES> files;
+  int                                                    files_count;
+  File_Watcher_Queue                                     queue;
+  bool                                                   using_inotify;
+#ifdef SDL_PLATFORM_LINUX
+  int inotify_fd = -1;
+#endif
+};
+
+static void file_watcher_push(File_Watcher* watcher, int id) {
+  auto queue = &watcher->queue;
+  auto tail  = SDL_GetAtomicInt(&queue->tail);
+  auto head  = SDL_GetAtomicInt(&queue->head);
+  if (tail - head >= FILE_WATCHER_QUEUE_CAPACITY) {
+    // The consumer treats an overflow as "everything changed", so nothing is lost.
+    SDL_SetAtomicInt(&queue->overflowed, 1);
+    return;
+  }
+
+  queue->items[tail & (FILE_WATCHER_QUEUE_CAPACITY - 1)] = id;
+  SDL_SetAtomicInt(&queue->tail, tail + 1);
+}
+
+static bool file_watcher_poll_files(File_Watcher* watcher) {
+  SDL_LockMutex(watcher->files_mutex);
+  defer(SDL_UnlockMutex(watcher->files_mutex));
+
+  for (int i = 0; i < watcher->files_count; i++) {
+    auto file = &watcher->files[i];
+
+    SDL_PathInfo path_info;
+    if (!SDL_GetPathInfo(file->full_path.c_str(), &path_info)) { continue; }
+    if (file->last_modify_time == path_info.modify_time) { continue; }
+    file->last_modify_time = path_info.modify_time;
+
+    file_watcher_push(watcher, file->id);
+  }
+
+  return true;
+}
+
+#ifdef SDL_PLATFORM_LINUX
+static void file_watcher_read_inotify_events(File_Watcher* watcher) {
+  alignas(inotify_event) char buffer[4096];
+  for (;;) {
+    auto length = read(watcher->inotify_fd, buffer, sizeof(buffer));
+    if (length <= 0) { return; }
+
+    SDL_LockMutex(watcher->files_mutex);
+    defer(SDL_UnlockMutex(watcher->files_mutex));
+
+    for (char* ptr = buffer; ptr < buffer + length;) {
+      auto event = reinterpret_cast<const inotify_event*>(ptr);
+      ptr += sizeof(inotify_event) + event->len;
+      if (event->len == 0) { continue; }
+
+      for (int i = 0; i < watcher->files_count; i++) {
+        const auto& file = watcher->files[i];
+        if (file.watch_descriptor != event->wd) { continue; }
+        if (SDL_strcmp(file.file_name, event->name) != 0) { continue; }
+        file_watcher_push(watcher, file.id);
+      }
+    }
+  }
+}
+#endif
+
+static int SDLCALL file_watcher_thread(void* user_data) {
+  auto watcher = static_cast<File_Watcher*>(user_data);
+
+  while (SDL_GetAtomicInt(&watcher->quit) == 0) {
+#ifdef SDL_PLATFORM_LINUX
+    if (watcher->using_inotify) {
+      pollfd poll_fd = {};
+      poll_fd.fd     = watcher->inotify_fd;
+      poll_fd.events = POLLIN;
+      // The timeout only bounds how long file_watcher_stop has to wait for the thread to exit.
+      if (poll(&poll_fd, 1, FILE_WATCHER_POLL_INTERVAL_MS) > 0) {
+        file_watcher_read_inotify_events(watcher);
+      }
+      continue;
+    }
+#endif
+    file_watcher_poll_files(watcher);
+    SDL_Delay(FILE_WATCHER_POLL_INTERVAL_MS);
+  }
+
+  return 0;
+}
+
+static void file_watcher_stop(File_Watcher* watcher) {
+  SDL_assert(watcher != nullptr);
+
+  if (watcher->thread != nullptr) {
+    SDL_SetAtomicInt(&watcher->quit, 1);
+    SDL_WaitThread(watcher->thread, nullptr);
+    watcher->thread = nullptr;
+  }
+
+#ifdef SDL_PLATFORM_LINUX
+  if (watcher->inotify_fd >= 0) {
+    close(watcher->inotify_fd);
+    watcher->inotify_fd = -1;
+  }
+#endif
+
+  SDL_DestroyMutex(watcher->files_mutex);
+  watcher->files_mutex = nullptr;
+}
+
+static bool file_watcher_start(File_Watcher* watcher, const char* base_path) {
+  SDL_assert(watcher != nullptr);
+  SDL_assert(base_path != nullptr);
+
+  watcher->base_path   = base_path;
+  watcher->files_mutex = SDL_CreateMutex();
+  if (watcher->files_mutex == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create mutex: %s", SDL_GetError());
+    return false;
+  }
+
+#ifdef SDL_PLATFORM_LINUX
+  watcher->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (watcher->inotify_fd >= 0) {
+    watcher->using_inotify = true;
+  } else {
+    SDL_LogWarn(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to init inotify, falling back to polling: %s",
+        strerror(errno));
+  }
+#endif
+
+  watcher->thread = SDL_CreateThread(file_watcher_thread, "file_watcher", watcher);
+  if (watcher->thread == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create thread: %s", SDL_GetError());
+    file_watcher_stop(watcher);
+    return false;
+  }
+
+  SDL_LogInfo(
+      SDL_LOG_CATEGORY_APPLICATION,
+      "File watcher started (%s)",
+      watcher->using_inotify ? "inotify" : "polling");
+
+  return true;
+}
+
+static bool file_watcher_add(File_Watcher* watcher, int id, const char* file_path) {
+  SDL_assert(watcher != nullptr);
+  SDL_assert(file_path != nullptr);
+
+  SDL_LockMutex(watcher->files_mutex);
+  defer(SDL_UnlockMutex(watcher->files_mutex));
+
+  for (int i = 0; i < watcher->files_count; i++) {
+    const auto& file = watcher->files[i];
+    if (file.id == id && file.file_path == file_path) { return true; }
+  }
+  if (watcher->files_count == FILE_WATCHER_MAX_FILES) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to watch %s: too many files", file_path);
+    return false;
+  }
+
+  auto file       = &watcher->files[watcher->files_count];
+  file->id        = id;
+  file->file_path = file_path;
+  file->full_path = watcher->base_path + file->file_path;
+
+  SDL_PathInfo path_info;
+  if (!SDL_GetPathInfo(file->full_path.c_str(), &path_info)) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to get path info: %s", SDL_GetError());
+    return false;
+  }
+  file->last_modify_time = path_info.modify_time;
+
+#ifdef SDL_PLATFORM_LINUX
+  if (watcher->using_inotify) {
+    // Watch the parent directory rather than the file itself. Most editors save by writing a
+    // temporary file and renaming it over the original, which would silently drop a file watch.
+    auto separator = file->file_path.find_last_of('/');
+    auto dir_path  = watcher->base_path;
+    auto name_pos  = size_t(0);
+    if (separator != std::string::npos) {
+      dir_path += file->file_path.substr(0, separator);
+      name_pos = separator + 1;
+    }
+    file->file_name = file->file_path.c_str() + name_pos;
+    file->watch_descriptor =
+        inotify_add_watch(watcher->inotify_fd, dir_path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (file->watch_descriptor < 0) {
+      SDL_LogError(
+          SDL_LOG_CATEGORY_APPLICATION,
+          "Failed to add inotify watch for %s: %s",
+          dir_path.c_str(),
+          strerror(errno));
+      return false;
+    }
+  }
+#endif
+
+  watcher->files_count += 1;
+
+  return true;
+}
+
+static bool file_watcher_pop(File_Watcher* watcher, int* out_id) {
+  SDL_assert(watcher != nullptr);
+  SDL_assert(out_id != nullptr);
+
+  auto queue = &watcher->queue;
+  auto head  = SDL_GetAtomicInt(&queue->head);
+  if (head == SDL_GetAtomicInt(&queue->tail)) { return false; }
+
+  *out_id = queue->items[head & (FILE_WATCHER_QUEUE_CAPACITY - 1)];
+  SDL_SetAtomicInt(&queue->head, head + 1);
+
+  return true;
+}
+
+static bool file_watcher_take_overflow(File_Watcher* watcher) {
+  SDL_assert(watcher != nullptr);
+
+  return SDL_SetAtomicInt(&watcher->queue.overflowed, 0) != 0;
+}
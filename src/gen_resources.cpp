@@ -0,0 +1,394 @@
+// Build time tool that compiles every shader to SPIRV, reflects its binding counts and writes the
+// Resource_ID enum, RESOURCES_INFO and RESOURCES_PERMUTATION_AXES tables that resources.cpp
+// includes. The output is only rewritten when it changes, so an unchanged table doesn't trigger a
+// rebuild. Optionally also lists every variant of every shader, for the build scripts to compile.
+//
+// Usage: gen_resources -o <output> [-v <variants>] <stage>:<hlsl file>[:<axes>]...
+//                      texture:<name>...
+//   <stage> is vertex, fragment or compute. Resource ids are assigned in argument order. Compute
+//   shaders become compute pipeline resources. <axes> are the permutation axes of the shader,
+//   separated by '+' (see resources.cpp). Every variant is compiled to check that it has the
+//   bindings of variant 0. Textures are generated at startup by the generator of the same name
+//   (noise_texture.cpp), so they have nothing to compile.
+//
+//   Each line of <variants> is "<stage> <file name> <variant file name> [-D<axis>...]".
+
+// -- External Header Includes ------------------------------------------------
+#include <SDL3/SDL.h>
+#include <SDL3_shadercross/SDL_shadercross.h>
+
+// -- Std Header Includes -----------------------------------------------------
+#include <string>
+#include <vector>
+
+// Matches SHADER_PERMUTATION_MAX_AXES in resources.cpp.
+static constexpr int SHADER_PERMUTATION_MAX_AXES = 4;
+
+struct Shader_Input {
+  std::string                 file_name;  // Without directory or extension.
+  bool                        texture;    // A generated texture rather than a shader.
+  const char*                 stage_arg;  // As given, e.g. "fragment".
+  const char*                 stage_name;
+  SDL_ShaderCross_ShaderStage stage;
+  std::vector<std::string>    axes;
+  Uint32                      samplers_count;
+  Uint32                      storage_textures_count;
+  Uint32                      storage_buffers_count;
+  Uint32                      uniform_buffers_count;
+  // Compute shaders only.
+  Uint32 readwrite_storage_textures_count;
+  Uint32 readwrite_storage_buffers_count;
+  Uint32 threadcount_x;
+  Uint32 threadcount_y;
+  Uint32 threadcount_z;
+};
+
+static bool parse_input(const char* arg, Shader_Input* out_input, std::string* out_file_path) {
+  auto separator = SDL_strchr(arg, ':');
+  if (separator == nullptr) { return false; }
+
+  auto stage_name = std::string(arg, separator - arg);
+  if (stage_name == "vertex") {
+    out_input->stage_arg  = "vertex";
+    out_input->stage_name = "VERTEX";
+    out_input->stage      = SDL_SHADERCROSS_SHADERSTAGE_VERTEX;
+  } else if (stage_name == "fragment") {
+    out_input->stage_arg  = "fragment";
+    out_input->stage_name = "FRAGMENT";
+    out_input->stage      = SDL_SHADERCROSS_SHADERSTAGE_FRAGMENT;
+  } else if (stage_name == "compute") {
+    out_input->stage_arg  = "compute";
+    out_input->stage_name = "COMPUTE";
+    out_input->stage      = SDL_SHADERCROSS_SHADERSTAGE_COMPUTE;
+  } else if (stage_name == "texture") {
+    out_input->stage_name = "TEXTURE";
+    out_input->texture    = true;
+  } else {
+    return false;
+  }
+
+  *out_file_path      = separator + 1;
+  auto axes_separator = out_file_path->find(':');
+  if (axes_separator != std::string::npos) {
+    auto axes = out_file_path->substr(axes_separator + 1);
+    out_file_path->resize(axes_separator);
+    size_t axis_start = 0;
+    while (axis_start < axes.size()) {
+      auto axis_end = axes.find('+', axis_start);
+      if (axis_end == std::string::npos) { axis_end = axes.size(); }
+      if (axis_end > axis_start) {
+        out_input->axes.push_back(axes.substr(axis_start, axis_end - axis_start));
+      }
+      axis_start = axis_end + 1;
+    }
+    if (out_input->axes.size() > SHADER_PERMUTATION_MAX_AXES) { return false; }
+  }
+
+  auto name_pos = out_file_path->find_last_of("/\\");
+  auto name     = name_pos == std::string::npos ? *out_file_path
+                                                : out_file_path->substr(name_pos + 1);
+  out_input->file_name = name.substr(0, name.find_last_of('.'));
+
+  return true;
+}
+
+// Reflects the variant of the shader, with bit i of the mask defining axis i.
+static bool reflect_shader(const std::string& file_path, Uint32 mask, Shader_Input* input) {
+  auto source = static_cast<char*>(SDL_LoadFile(file_path.c_str(), nullptr));
+  if (source == nullptr) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to load %s: %s",
+        file_path.c_str(),
+        SDL_GetError());
+    return false;
+  }
+
+  auto name_pos    = file_path.find_last_of("/\\");
+  auto include_dir = name_pos == std::string::npos ? std::string(".")
+                                                   : file_path.substr(0, name_pos);
+  auto define_name = std::string(input->stage_name) + "_SHADER";
+
+  // The stage define, then those of the variant, terminated by an empty define.
+  std::vector<SDL_ShaderCross_HLSL_Define> defines = {{define_name.data(), nullptr}};
+  for (size_t i = 0; i < input->axes.size(); i++) {
+    if ((mask & (1u << i)) == 0) { continue; }
+    defines.push_back({input->axes[i].data(), nullptr});
+  }
+  defines.push_back({});
+
+  SDL_ShaderCross_HLSL_Info hlsl_info = {};
+  hlsl_info.source                    = source;
+  hlsl_info.entrypoint                = "main";
+  hlsl_info.include_dir               = include_dir.c_str();
+  hlsl_info.defines                   = defines.data();
+  hlsl_info.shader_stage              = input->stage;
+
+  size_t spirv_size;
+  auto   spirv = static_cast<Uint8*>(SDL_ShaderCross_CompileSPIRVFromHLSL(&hlsl_info, &spirv_size));
+  SDL_free(source);
+  if (spirv == nullptr) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to compile variant %u of %s:\n%s",
+        mask,
+        file_path.c_str(),
+        SDL_GetError());
+    return false;
+  }
+
+  if (input->stage == SDL_SHADERCROSS_SHADERSTAGE_COMPUTE) {
+    auto metadata = SDL_ShaderCross_ReflectComputeSPIRV(spirv, spirv_size, 0);
+    SDL_free(spirv);
+    if (metadata == nullptr) {
+      SDL_LogError(
+          SDL_LOG_CATEGORY_APPLICATION,
+          "Failed to reflect %s: %s",
+          file_path.c_str(),
+          SDL_GetError());
+      return false;
+    }
+
+    // The storage counts of graphics shaders are the read only ones.
+    input->samplers_count                   = metadata->num_samplers;
+    input->storage_textures_count           = metadata->num_readonly_storage_textures;
+    input->storage_buffers_count            = metadata->num_readonly_storage_buffers;
+    input->readwrite_storage_textures_count = metadata->num_readwrite_storage_textures;
+    input->readwrite_storage_buffers_count  = metadata->num_readwrite_storage_buffers;
+    input->uniform_buffers_count            = metadata->num_uniform_buffers;
+    input->threadcount_x                    = metadata->threadcount_x;
+    input->threadcount_y                    = metadata->threadcount_y;
+    input->threadcount_z                    = metadata->threadcount_z;
+    SDL_free(metadata);
+
+    return true;
+  }
+
+  auto metadata = SDL_ShaderCross_ReflectGraphicsSPIRV(spirv, spirv_size, 0);
+  SDL_free(spirv);
+  if (metadata == nullptr) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to reflect %s: %s",
+        file_path.c_str(),
+        SDL_GetError());
+    return false;
+  }
+
+  input->samplers_count         = metadata->resource_info.num_samplers;
+  input->storage_textures_count = metadata->resource_info.num_storage_textures;
+  input->storage_buffers_count  = metadata->resource_info.num_storage_buffers;
+  input->uniform_buffers_count  = metadata->resource_info.num_uniform_buffers;
+  SDL_free(metadata);
+
+  return true;
+}
+
+static bool same_bindings(const Shader_Input& a, const Shader_Input& b) {
+  return a.samplers_count == b.samplers_count &&
+         a.storage_textures_count == b.storage_textures_count &&
+         a.storage_buffers_count == b.storage_buffers_count &&
+         a.uniform_buffers_count == b.uniform_buffers_count &&
+         a.readwrite_storage_textures_count == b.readwrite_storage_textures_count &&
+         a.readwrite_storage_buffers_count == b.readwrite_storage_buffers_count &&
+         a.threadcount_x == b.threadcount_x && a.threadcount_y == b.threadcount_y &&
+         a.threadcount_z == b.threadcount_z;
+}
+
+// Reflects variant 0 of the shader into the input, and checks that every other variant matches it.
+static bool reflect_variants(const std::string& file_path, Shader_Input* input) {
+  if (!reflect_shader(file_path, 0, input)) { return false; }
+
+  auto variants_count = 1u << input->axes.size();
+  for (Uint32 mask = 1; mask < variants_count; mask++) {
+    auto variant = *input;
+    if (!reflect_shader(file_path, mask, &variant)) { return false; }
+    if (!same_bindings(*input, variant)) {
+      SDL_LogError(
+          SDL_LOG_CATEGORY_APPLICATION,
+          "Variant %u of %s has other bindings than variant 0",
+          mask,
+          file_path.c_str());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Matches shader_variant_file_name in resources.cpp.
+static std::string variant_file_name(const Shader_Input& input, Uint32 mask) {
+  if (mask == 0) { return input.file_name; }
+  return input.file_name + "_p" + std::to_string(mask);
+}
+
+static std::string resource_id_name(const Shader_Input& input) {
+  auto name = input.texture
+                  ? std::string("RESOURCE_ID_TEXTURE_") + input.file_name
+                  : std::string("RESOURCE_ID_SHADER_") + input.stage_name + "_" + input.file_name;
+  for (auto& c : name) { c = static_cast<char>(SDL_toupper(c)); }
+
+  return name;
+}
+
+static std::string generate(const std::vector<Shader_Input>& inputs) {
+  std::string out;
+  out += "// Generated by gen_resources.cpp, do not edit.\n";
+  out += "\n";
+  out += "enum Resource_ID {\n";
+  for (const auto& input : inputs) { out += "  " + resource_id_name(input) + ",\n"; }
+  out += "  RESOURCE_ID_COUNT,\n";
+  out += "};\n";
+  out += "\n";
+  out += "// Shader bindings are samplers, storage textures, storage buffers, uniform buffers.\n";
+  out += "// Compute bindings are samplers, read only storage textures and buffers, read write\n";
+  out += "// storage textures and buffers, uniform buffers, then the thread counts.\n";
+  out += "static constexpr std::array<Resource_Info, RESOURCE_ID_COUNT> RESOURCES_INFO = {{\n";
+  for (const auto& input : inputs) {
+    char line[256];
+    if (input.texture) {
+      SDL_snprintf(
+          line,
+          sizeof(line),
+          "    {RESOURCE_KIND_TEXTURE, \"%s\", {}, {}},\n",
+          input.file_name.c_str());
+      out += line;
+      continue;
+    }
+    if (input.stage == SDL_SHADERCROSS_SHADERSTAGE_COMPUTE) {
+      SDL_snprintf(
+          line,
+          sizeof(line),
+          "    {RESOURCE_KIND_COMPUTE_PIPELINE, \"%s\", {}, "
+          "{{%u, %u, %u, %u, %u, %u, %u, %u, %u}}},\n",
+          input.file_name.c_str(),
+          input.samplers_count,
+          input.storage_textures_count,
+          input.storage_buffers_count,
+          input.readwrite_storage_textures_count,
+          input.readwrite_storage_buffers_count,
+          input.uniform_buffers_count,
+          input.threadcount_x,
+          input.threadcount_y,
+          input.threadcount_z);
+      out += line;
+      continue;
+    }
+    SDL_snprintf(
+        line,
+        sizeof(line),
+        "    {RESOURCE_KIND_SHADER, \"%s\", {SDL_GPU_SHADERSTAGE_%s, {%u, %u, %u, %u}}, {}},\n",
+        input.file_name.c_str(),
+        input.stage_name,
+        input.samplers_count,
+        input.storage_textures_count,
+        input.storage_buffers_count,
+        input.uniform_buffers_count);
+    out += line;
+  }
+  out += "}};\n";
+  out += "\n";
+  out += "// The permutation axes of every resource, followed by its file name.\n";
+  out += "static constexpr std::array<Shader_Permutation_Axes, RESOURCE_ID_COUNT>\n";
+  out += "    RESOURCES_PERMUTATION_AXES = {{\n";
+  std::vector<std::string> entries;
+  size_t                   entries_width = 0;
+  for (const auto& input : inputs) {
+    std::string axes;
+    for (const auto& axis : input.axes) { axes += (axes.empty() ? "\"" : ", \"") + axis + "\""; }
+    entries.push_back(axes.empty() ? "    {}," : "    {{" + axes + "}},");
+    entries_width = SDL_max(entries_width, entries.back().size());
+  }
+  for (size_t i = 0; i < inputs.size(); i++) {
+    entries[i].resize(entries_width, ' ');
+    out += entries[i] + "  // " + inputs[i].file_name + "\n";
+  }
+  out += "}};\n";
+
+  return out;
+}
+
+static std::string generate_variants(const std::vector<Shader_Input>& inputs) {
+  std::string out;
+  for (const auto& input : inputs) {
+    if (input.texture) { continue; }
+
+    auto variants_count = 1u << input.axes.size();
+    for (Uint32 mask = 0; mask < variants_count; mask++) {
+      out += std::string(input.stage_arg) + " " + input.file_name + " " +
+             variant_file_name(input, mask);
+      for (size_t i = 0; i < input.axes.size(); i++) {
+        if ((mask & (1u << i)) != 0) { out += " -D" + input.axes[i]; }
+      }
+      out += "\n";
+    }
+  }
+
+  return out;
+}
+
+// Only rewrites the file when the contents changed.
+static bool save_if_changed(const char* path, const std::string& contents) {
+  size_t existing_size = 0;
+  auto   existing      = SDL_LoadFile(path, &existing_size);
+  bool   unchanged     = existing != nullptr && existing_size == contents.size() &&
+                   SDL_memcmp(existing, contents.data(), existing_size) == 0;
+  SDL_free(existing);
+  if (unchanged) { return true; }
+
+  if (!SDL_SaveFile(path, contents.data(), contents.size())) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to save %s: %s", path, SDL_GetError());
+    return false;
+  }
+  SDL_Log("Generated %s", path);
+
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  const char*               output_path   = nullptr;
+  const char*               variants_path = nullptr;
+  std::vector<Shader_Input> inputs;
+  std::vector<std::string>  input_paths;
+  for (int i = 1; i < argc; i++) {
+    if (SDL_strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      output_path = argv[++i];
+      continue;
+    }
+    if (SDL_strcmp(argv[i], "-v") == 0 && i + 1 < argc) {
+      variants_path = argv[++i];
+      continue;
+    }
+
+    Shader_Input input = {};
+    std::string  input_path;
+    if (!parse_input(argv[i], &input, &input_path)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Invalid shader argument: %s", argv[i]);
+      return 1;
+    }
+    inputs.push_back(input);
+    input_paths.push_back(input_path);
+  }
+  if (output_path == nullptr || inputs.empty()) {
+    SDL_Log(
+        "Usage: %s -o <output> [-v <variants>] <stage>:<hlsl file>[:<axes>]... texture:<name>...",
+        argv[0]);
+    return 1;
+  }
+
+  if (!SDL_ShaderCross_Init()) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to init shadercross: %s", SDL_GetError());
+    return 1;
+  }
+  for (size_t i = 0; i < inputs.size(); i++) {
+    if (!inputs[i].texture && !reflect_variants(input_paths[i], &inputs[i])) { return 1; }
+  }
+  SDL_ShaderCross_Quit();
+
+  if (!save_if_changed(output_path, generate(inputs))) { return 1; }
+  if (variants_path != nullptr && !save_if_changed(variants_path, generate_variants(inputs))) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+// -- GPU Release Queue -------------------------------------------------------
+//
+// Defers releasing GPU objects that are replaced at run time (live reloaded shaders, rebuilt
+// pipelines, resized render targets) until the GPU has finished every frame that could still be
+// using them. Each retired object is tagged with the index of the frame being recorded, and every
+// submitted frame leaves a fence behind; an object is released once the fence of its frame (or a
+// later one, as submissions complete in order) has signalled. Only used from the main thread.
+//
+// The fences live in a fixed size ring so that a frame that retires nothing doesn't allocate.
+
+static constexpr int GPU_RELEASE_QUEUE_MAX_FENCES = 8;
+
+enum GPU_Object_Kind {
+  GPU_OBJECT_KIND_SHADER,
+  GPU_OBJECT_KIND_GRAPHICS_PIPELINE,
+  GPU_OBJECT_KIND_COMPUTE_PIPELINE,
+  GPU_OBJECT_KIND_TEXTURE,
+};
+
+struct GPU_Retired_Object {
+  GPU_Object_Kind kind;
+  void*           handle;
+  uint64_t        frame_index;
+};
+
+struct GPU_Frame_Fence {
+  SDL_GPUFence* fence;
+  uint64_t      frame_index;
+};
+
+struct GPU_Release_Queue {
+  std::deque<GPU_Retired_Object> objects;  // Oldest first.
+  // Of the frames in flight, oldest first from fences_head.
+  std::array<GPU_Frame_Fence, GPU_RELEASE_QUEUE_MAX_FENCES> fences;
+  int                                                       fences_head;
+  int                                                       fences_count;
+  uint64_t                                                  frame_index;
+};
+
+static void gpu_object_release(SDL_GPUDevice* device, const GPU_Retired_Object& object) {
+  switch (object.kind) {
+  case GPU_OBJECT_KIND_SHADER:
+    SDL_ReleaseGPUShader(device, static_cast<SDL_GPUShader*>(object.handle));
+    break;
+  case GPU_OBJECT_KIND_GRAPHICS_PIPELINE:
+    SDL_ReleaseGPUGraphicsPipeline(device, static_cast<SDL_GPUGraphicsPipeline*>(object.handle));
+    break;
+  case GPU_OBJECT_KIND_COMPUTE_PIPELINE:
+    SDL_ReleaseGPUComputePipeline(device, static_cast<SDL_GPUComputePipeline*>(object.handle));
+    break;
+  case GPU_OBJECT_KIND_TEXTURE:
+    SDL_ReleaseGPUTexture(device, static_cast<SDL_GPUTexture*>(object.handle));
+    break;
+  }
+}
+
+static void gpu_release_queue_push(GPU_Release_Queue* queue, GPU_Object_Kind kind, void* handle) {
+  SDL_assert(queue != nullptr);
+
+  if (handle == nullptr) { return; }
+  queue->objects.push_back({kind, handle, queue->frame_index});
+}
+
+// Releases every object whose frames have all completed on the GPU. Never blocks.
+static void gpu_release_queue_collect(GPU_Release_Queue* queue, SDL_GPUDevice* device) {
+  SDL_assert(queue != nullptr);
+  SDL_assert(device != nullptr);
+
+  bool     any_completed         = false;
+  uint64_t completed_frame_index = 0;
+  while (queue->fences_count > 0) {
+    const auto& oldest = queue->fences[queue->fences_head];
+    if (!SDL_QueryGPUFence(device, oldest.fence)) { break; }
+    any_completed         = true;
+    completed_frame_index = oldest.frame_index;
+    SDL_ReleaseGPUFence(device, oldest.fence);
+    queue->fences_head   = (queue->fences_head + 1) % GPU_RELEASE_QUEUE_MAX_FENCES;
+    queue->fences_count -= 1;
+  }
+  if (!any_completed) { return; }
+
+  while (!queue->objects.empty() && queue->objects.front().frame_index <= completed_frame_index) {
+    gpu_object_release(device, queue->objects.front());
+    queue->objects.pop_front();
+  }
+}
+
+// Call once per frame with the fence returned by SDL_SubmitGPUCommandBufferAndAcquireFence (which
+// may be null if the submission failed). Blocks on the oldest frame if the ring of fences is full,
+// which only happens when nothing else (e.g. the swapchain) limits the frames in flight.
+static void gpu_release_queue_end_frame(
+    GPU_Release_Queue* queue,
+    SDL_GPUDevice*     device,
+    SDL_GPUFence*      fence) {
+  SDL_assert(queue != nullptr);
+  SDL_assert(device != nullptr);
+
+  if (fence != nullptr) {
+    if (queue->fences_count == GPU_RELEASE_QUEUE_MAX_FENCES) {
+      SDL_WaitForGPUFences(device, true, &queue->fences[queue->fences_head].fence, 1);
+      gpu_release_queue_collect(queue, device);
+    }
+    auto tail           = (queue->fences_head + queue->fences_count) % GPU_RELEASE_QUEUE_MAX_FENCES;
+    queue->fences[tail] = {fence, queue->frame_index};
+    queue->fences_count += 1;
+  }
+  queue->frame_index += 1;
+}
+
+// Blocks until the GPU has finished the last submitted frame, unless it already has.
+static void gpu_release_queue_wait_last_frame(GPU_Release_Queue* queue, SDL_GPUDevice* device) {
+  SDL_assert(queue != nullptr);
+  SDL_assert(device != nullptr);
+
+  if (queue->fences_count == 0) { return; }
+  auto last  = (queue->fences_head + queue->fences_count - 1) % GPU_RELEASE_QUEUE_MAX_FENCES;
+  auto fence = queue->fences[last].fence;
+  if (!SDL_QueryGPUFence(device, fence)) { SDL_WaitForGPUFences(device, true, &fence, 1); }
+}
+
+// Releases everything, pending or not. The GPU must be idle.
+static void gpu_release_queue_destroy(GPU_Release_Queue* queue, SDL_GPUDevice* device) {
+  SDL_assert(queue != nullptr);
+  SDL_assert(device != nullptr);
+
+  for (const auto& object : queue->objects) { gpu_object_release(device, object); }
+  for (int i = 0; i < queue->fences_count; i++) {
+    auto index = (queue->fences_head + i) % GPU_RELEASE_QUEUE_MAX_FENCES;
+    SDL_ReleaseGPUFence(device, queue->fences[index].fence);
+  }
+  queue->objects.clear();
+  queue->fences_head  = 0;
+  queue->fences_count = 0;
+}
@@ -0,0 +1,126 @@
+// -- Job Pool ----------------------------------------------------------------
+//
+// A small fixed size pool of worker threads pulling jobs from a shared FIFO queue. Jobs are plain
+// function pointers plus user data; results are communicated back through the user data.
+
+typedef void (*Job_Func)(void* user_data);
+
+struct Job {
+  Job_Func func;
+  void*    user_data;
+};
+
+struct Job_Pool {
+  std::vector<SDL_Thread*> threads;
+  SDL_Mutex*               mutex;
+  SDL_Condition*           job_available;
+  SDL_Condition*           jobs_finished;
+  std::deque<Job>          queue;
+  bool                     quit;
+  SDL_AtomicInt            queued_count;
+  SDL_AtomicInt            running_count;
+};
+
+static int SDLCALL job_pool_worker(void* user_data) {
+  auto pool = static_cast<Job_Pool*>(user_data);
+
+  for (;;) {
+    Job job;
+    {
+      SDL_LockMutex(pool->mutex);
+      defer(SDL_UnlockMutex(pool->mutex));
+
+      while (pool->queue.empty() && !pool->quit) {
+        SDL_WaitCondition(pool->job_available, pool->mutex);
+      }
+      if (pool->quit && pool->queue.empty()) { return 0; }
+
+      job = pool->queue.front();
+      pool->queue.pop_front();
+      SDL_AddAtomicInt(&pool->running_count, 1);
+      SDL_AddAtomicInt(&pool->queued_count, -1);
+    }
+
+    job.func(job.user_data);
+
+    SDL_LockMutex(pool->mutex);
+    SDL_AddAtomicInt(&pool->running_count, -1);
+    SDL_BroadcastCondition(pool->jobs_finished);
+    SDL_UnlockMutex(pool->mutex);
+  }
+}
+
+static bool job_pool_init(Job_Pool* pool, int threads_count) {
+  SDL_assert(pool != nullptr);
+  SDL_assert(threads_count > 0);
+
+  pool->mutex         = SDL_CreateMutex();
+  pool->job_available = SDL_CreateCondition();
+  pool->jobs_finished = SDL_CreateCondition();
+  if (pool->mutex == nullptr || pool->job_available == nullptr ||
+      pool->jobs_finished == nullptr) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to create job pool sync primitives: %s",
+        SDL_GetError());
+    return false;
+  }
+
+  for (int i = 0; i < threads_count; i++) {
+    char name[32];
+    SDL_snprintf(name, sizeof(name), "job_worker_%d", i);
+    auto thread = SDL_CreateThread(job_pool_worker, name, pool);
+    if (thread == nullptr) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create thread: %s", SDL_GetError());
+      return false;
+    }
+    pool->threads.push_back(thread);
+  }
+
+  return true;
+}
+
+static void job_pool_push(Job_Pool* pool, Job_Func func, void* user_data) {
+  SDL_assert(pool != nullptr);
+  SDL_assert(func != nullptr);
+
+  SDL_LockMutex(pool->mutex);
+  defer(SDL_UnlockMutex(pool->mutex));
+
+  pool->queue.push_back({func, user_data});
+  SDL_AddAtomicInt(&pool->queued_count, 1);
+  SDL_SignalCondition(pool->job_available);
+}
+
+// Blocks until the queue is empty and no job is running.
+static void job_pool_wait(Job_Pool* pool) {
+  SDL_assert(pool != nullptr);
+
+  SDL_LockMutex(pool->mutex);
+  defer(SDL_UnlockMutex(pool->mutex));
+
+  while (!pool->queue.empty() || SDL_GetAtomicInt(&pool->running_count) > 0) {
+    SDL_WaitCondition(pool->jobs_finished, pool->mutex);
+  }
+}
+
+static void job_pool_destroy(Job_Pool* pool) {
+  SDL_assert(pool != nullptr);
+
+  if (pool->mutex != nullptr) {
+    SDL_LockMutex(pool->mutex);
+    pool->quit = true;
+    SDL_BroadcastCondition(pool->job_available);
+    SDL_UnlockMutex(pool->mutex);
+  }
+
+  for (auto thread : pool->threads) { SDL_WaitThread(thread, nullptr); }
+  pool->threads.clear();
+
+  SDL_DestroyCondition(pool->jobs_finished);
+  SDL_DestroyCondition(pool->job_available);
+  SDL_DestroyMutex(pool->mutex);
+  pool->jobs_finished = nullptr;
+  pool->job_available = nullptr;
+  pool->mutex         = nullptr;
+}
@@ -0,0 +1,210 @@
+// -- Noise Texture -----------------------------------------------------------
+//
+// Generators of the RESOURCE_KIND_TEXTURE resources, which are computed at startup rather than
+// read from disk. The noise lattice holds hash() from common.hlsl at every integer point of a
+// 256x256 tile, so that value noise can fetch the four corners of its cell with one texture gather
+// instead of evaluating four sin() based hashes. Sampled with wrapping, the lattice tiles.
+//
+// The hash is evaluated four texels at a time with SSE2 where available. Both paths use the same
+// polynomial sine rather than the C library's, so that they produce the same texels.
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define NOISE_TEXTURE_SSE2
+#endif
+
+// Matches NOISE_LATTICE_SIZE in fbm_warp_common.hlsl.
+static constexpr int NOISE_LATTICE_SIZE = 256;
+
+typedef void (*Texture_Generate_Func)(uint8_t* texels);
+typedef void (*Texture_Report_Func)(const uint8_t* texels);
+
+struct Texture_Generator {
+  const char*           name;  // The file name of the resource it generates.
+  SDL_GPUTextureFormat  format;
+  int                   width;
+  int                   height;
+  int                   bytes_per_texel;
+  Texture_Generate_Func generate;
+  Texture_Report_Func   report;  // Logs the quality of the generated texels, may be null.
+};
+
+static constexpr float NOISE_PI          = 3.14159265f;
+static constexpr float NOISE_HALF_PI     = 1.57079633f;
+static constexpr float NOISE_INV_TWO_PI  = 0.159154943f;
+static constexpr float NOISE_TWO_PI_HIGH = 6.28125f;  // Exact in a float, for the range reduction.
+static constexpr float NOISE_TWO_PI_LOW  = 0.00193530717f;
+
+// Taylor series of sin up to x^9, accurate to about 4e-6 over [-pi/2, pi/2].
+static constexpr float NOISE_SIN_C3 = -1.0f / 6.0f;
+static constexpr float NOISE_SIN_C5 = 1.0f / 120.0f;
+static constexpr float NOISE_SIN_C7 = -1.0f / 5040.0f;
+static constexpr float NOISE_SIN_C9 = 1.0f / 362880.0f;
+
+static float noise_sin(float x) {
+  float k = SDL_floorf(x * NOISE_INV_TWO_PI + 0.5f);
+  float r = (x - k * NOISE_TWO_PI_HIGH) - k * NOISE_TWO_PI_LOW;
+  if (r > NOISE_HALF_PI) { r = NOISE_PI - r; }
+  if (r < -NOISE_HALF_PI) { r = -NOISE_PI - r; }
+
+  float r2 = r * r;
+  float p  = NOISE_SIN_C7 + r2 * NOISE_SIN_C9;
+  p        = NOISE_SIN_C5 + r2 * p;
+  p        = NOISE_SIN_C3 + r2 * p;
+  return r + r * r2 * p;
+}
+
+// hash(float2 p) from common.hlsl, with the sine passed in.
+template<typename Sin_Func>
+static float noise_hash(float x, float y, Sin_Func sin) {
+  float v = 1e4f * sin(17.0f * x + y * 0.1f) * (0.1f + SDL_fabsf(sin(y * 13.0f + x)));
+  return v - SDL_floorf(v);
+}
+
+static uint8_t noise_quantize(float v) {
+  return static_cast<uint8_t>(v * 255.0f + 0.5f);
+}
+
+#ifdef NOISE_TEXTURE_SSE2
+// Only for |x| < 2^31.
+static __m128 noise_floor_4(__m128 x) {
+  auto t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+  return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.0f)));
+}
+
+static __m128 noise_select_4(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// noise_sin, four at a time.
+static __m128 noise_sin_4(__m128 x) {
+  auto pi          = _mm_set1_ps(NOISE_PI);
+  auto half_pi     = _mm_set1_ps(NOISE_HALF_PI);
+  auto neg_pi      = _mm_set1_ps(-NOISE_PI);
+  auto neg_half_pi = _mm_set1_ps(-NOISE_HALF_PI);
+
+  auto k = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(NOISE_INV_TWO_PI)), _mm_set1_ps(0.5f));
+  k      = noise_floor_4(k);
+  auto r = _mm_sub_ps(x, _mm_mul_ps(k, _mm_set1_ps(NOISE_TWO_PI_HIGH)));
+  r      = _mm_sub_ps(r, _mm_mul_ps(k, _mm_set1_ps(NOISE_TWO_PI_LOW)));
+  r      = noise_select_4(_mm_cmpgt_ps(r, half_pi), _mm_sub_ps(pi, r), r);
+  r      = noise_select_4(_mm_cmplt_ps(r, neg_half_pi), _mm_sub_ps(neg_pi, r), r);
+
+  auto r2 = _mm_mul_ps(r, r);
+  auto p  = _mm_add_ps(_mm_set1_ps(NOISE_SIN_C7), _mm_mul_ps(r2, _mm_set1_ps(NOISE_SIN_C9)));
+  p       = _mm_add_ps(_mm_set1_ps(NOISE_SIN_C5), _mm_mul_ps(r2, p));
+  p       = _mm_add_ps(_mm_set1_ps(NOISE_SIN_C3), _mm_mul_ps(r2, p));
+  return _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), p));
+}
+
+// noise_hash with noise_sin, four at a time.
+static __m128 noise_hash_4(__m128 x, __m128 y) {
+  auto a = noise_sin_4(
+      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(17.0f), x), _mm_mul_ps(y, _mm_set1_ps(0.1f))));
+  auto b = noise_sin_4(_mm_add_ps(_mm_mul_ps(y, _mm_set1_ps(13.0f)), x));
+
+  auto abs_b = _mm_andnot_ps(_mm_set1_ps(-0.0f), b);
+  auto v     = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(1e4f), a), _mm_add_ps(_mm_set1_ps(0.1f), abs_b));
+  return _mm_sub_ps(v, noise_floor_4(v));
+}
+#endif
+
+static void noise_lattice_generate(uint8_t* texels) {
+  for (int y = 0; y < NOISE_LATTICE_SIZE; y++) {
+    auto row = texels + y * NOISE_LATTICE_SIZE;
+    int  x   = 0;
+#ifdef NOISE_TEXTURE_SSE2
+    auto ys      = _mm_set1_ps(static_cast<float>(y));
+    auto offsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    for (; x + 4 <= NOISE_LATTICE_SIZE; x += 4) {
+      auto xs = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+      auto v  = noise_hash_4(xs, ys);
+      // noise_quantize, then narrowed to bytes (saturating, though nothing is out of range).
+      auto q = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+      q      = _mm_packs_epi32(q, q);
+      q      = _mm_packus_epi16(q, q);
+
+      auto packed = _mm_cvtsi128_si32(q);
+      SDL_memcpy(row + x, &packed, sizeof(packed));
+    }
+#endif
+    for (; x < NOISE_LATTICE_SIZE; x++) {
+      auto v = noise_hash(static_cast<float>(x), static_cast<float>(y), noise_sin);
+      row[x] = noise_quantize(v);
+    }
+  }
+}
+
+struct Noise_Stats {
+  double mean;
+  double stddev;
+  double neighbour_correlation;  // Of horizontally adjacent values, ~0 for a good hash.
+};
+
+template<typename Value_Func>
+static Noise_Stats noise_stats(Value_Func value) {
+  double sum         = 0.0;
+  double sum_squares = 0.0;
+  double sum_product = 0.0;
+  for (int y = 0; y < NOISE_LATTICE_SIZE; y++) {
+    for (int x = 0; x < NOISE_LATTICE_SIZE; x++) {
+      double v = value(x, y);
+      sum += v;
+      sum_squares += v * v;
+      sum_product += v * value((x + 1) % NOISE_LATTICE_SIZE, y);
+    }
+  }
+
+  double count      = static_cast<double>(NOISE_LATTICE_SIZE * NOISE_LATTICE_SIZE);
+  double mean       = sum / count;
+  double variance   = sum_squares / count - mean * mean;
+  double covariance = sum_product / count - mean * mean;
+
+  Noise_Stats stats           = {};
+  stats.mean                  = mean;
+  stats.stddev                = SDL_sqrt(variance);
+  stats.neighbour_correlation = variance > 0.0 ? covariance / variance : 0.0;
+
+  return stats;
+}
+
+// Compares the distribution of the lattice against that of the analytic hash, evaluated with the C
+// library's sine (the GPU's differs again). The values can't be compared one by one: the hash
+// scales its sines by 1e4 before taking the fraction, so any two sine implementations give
+// unrelated values. An ideal hash has a mean of 0.5, a standard deviation of 0.289 (uniform) and no
+// correlation between neighbours.
+static void noise_lattice_log_quality(const uint8_t* texels) {
+  auto lattice = noise_stats([&](int x, int y) {
+    return texels[y * NOISE_LATTICE_SIZE + x] / 255.0;
+  });
+  auto analytic = noise_stats([](int x, int y) {
+    return noise_hash(static_cast<float>(x), static_cast<float>(y), SDL_sinf);
+  });
+  SDL_LogInfo(
+      SDL_LOG_CATEGORY_APPLICATION,
+      "Noise lattice: mean %.4f (analytic %.4f), stddev %.4f (analytic %.4f), neighbour "
+      "correlation %.4f (analytic %.4f)",
+      lattice.mean,
+      analytic.mean,
+      lattice.stddev,
+      analytic.stddev,
+      lattice.neighbour_correlation,
+      analytic.neighbour_correlation);
+}
+
+static constexpr std::array<Texture_Generator, 1> TEXTURE_GENERATORS = {{
+    {"noise_lattice",
+     SDL_GPU_TEXTUREFORMAT_R8_UNORM,
+     NOISE_LATTICE_SIZE,
+     NOISE_LATTICE_SIZE,
+     1,
+     noise_lattice_generate,
+     noise_lattice_log_quality},
+}};
+
+static const Texture_Generator* texture_generator_find(const char* name) {
+  for (const auto& generator : TEXTURE_GENERATORS) {
+    if (SDL_strcmp(generator.name, name) == 0) { return &generator; }
+  }
+
+  return nullptr;
+}
@@ -0,0 +1,124 @@
+// Build time tool that packs compiled resources into a single resource pack (see
+// resource_pack.cpp) for release builds.
+//
+// Usage: pack_resources [-c] -o <output> <input>...
+//   -c  Compress entries with LZ4 when that makes them smaller.
+
+// -- External Header Includes ------------------------------------------------
+#include <SDL3/SDL.h>
+
+// -- Std Header Includes -----------------------------------------------------
+#include <string>
+#include <vector>
+
+// -- Local Source Includes ---------------------------------------------------
+#include "resource_pack.cpp"
+
+struct Pack_Input {
+  std::string          name;
+  std::vector<uint8_t> data;
+  uint32_t             uncompressed_size;
+  uint32_t             flags;
+};
+
+static bool load_input(const char* file_path, bool compress, Pack_Input* out_input) {
+  size_t file_size = 0;
+  auto   file_data = static_cast<uint8_t*>(SDL_LoadFile(file_path, &file_size));
+  if (file_data == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load %s: %s", file_path, SDL_GetError());
+    return false;
+  }
+
+  const char* name = SDL_strrchr(file_path, '/');
+  if (name == nullptr) { name = SDL_strrchr(file_path, '\\'); }
+  name = name != nullptr ? name + 1 : file_path;
+  if (SDL_strlen(name) >= RESOURCE_PACK_MAX_NAME_SIZE) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Resource name too long: %s", name);
+    SDL_free(file_data);
+    return false;
+  }
+
+  out_input->name              = name;
+  out_input->uncompressed_size = static_cast<uint32_t>(file_size);
+  out_input->flags             = 0;
+  if (compress) { lz4_compress(file_data, file_size, &out_input->data); }
+  if (compress && out_input->data.size() < file_size) {
+    out_input->flags = RESOURCE_PACK_FLAG_LZ4;
+  } else {
+    out_input->data.assign(file_data, file_data + file_size);
+  }
+  SDL_free(file_data);
+
+  return true;
+}
+
+static bool write_pack(const char* file_path, const std::vector<Pack_Input>& inputs) {
+  Resource_Pack_Header header = {};
+  header.magic                = RESOURCE_PACK_MAGIC;
+  header.version              = RESOURCE_PACK_VERSION;
+  header.entries_count        = static_cast<uint32_t>(inputs.size());
+
+  std::vector<Resource_Pack_Entry> entries(inputs.size());
+  uint64_t offset = sizeof(header) + entries.size() * sizeof(Resource_Pack_Entry);
+  for (size_t i = 0; i < inputs.size(); i++) {
+    offset = (offset + RESOURCE_PACK_ALIGNMENT - 1) & ~uint64_t(RESOURCE_PACK_ALIGNMENT - 1);
+
+    auto entry = &entries[i];
+    SDL_strlcpy(entry->name, inputs[i].name.c_str(), sizeof(entry->name));
+    entry->offset            = offset;
+    entry->size              = static_cast<uint32_t>(inputs[i].data.size());
+    entry->uncompressed_size = inputs[i].uncompressed_size;
+    entry->flags             = inputs[i].flags;
+    offset += entry->size;
+  }
+
+  std::vector<uint8_t> contents(offset, 0);
+  SDL_memcpy(contents.data(), &header, sizeof(header));
+  SDL_memcpy(contents.data() + sizeof(header), entries.data(), entries.size() * sizeof(entries[0]));
+  for (size_t i = 0; i < inputs.size(); i++) {
+    SDL_memcpy(contents.data() + entries[i].offset, inputs[i].data.data(), entries[i].size);
+  }
+
+  if (!SDL_SaveFile(file_path, contents.data(), contents.size())) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to save %s: %s", file_path, SDL_GetError());
+    return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  bool                     compress    = false;
+  const char*              output_path = nullptr;
+  std::vector<const char*> input_paths;
+  for (int i = 1; i < argc; i++) {
+    if (SDL_strcmp(argv[i], "-c") == 0) {
+      compress = true;
+    } else if (SDL_strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      output_path = argv[++i];
+    } else {
+      input_paths.push_back(argv[i]);
+    }
+  }
+  if (output_path == nullptr || input_paths.empty()) {
+    SDL_Log("Usage: %s [-c] -o <output> <input>...", argv[0]);
+    return 1;
+  }
+
+  std::vector<Pack_Input> inputs(input_paths.size());
+  for (size_t i = 0; i < input_paths.size(); i++) {
+    if (!load_input(input_paths[i], compress, &inputs[i])) { return 1; }
+  }
+
+  if (!write_pack(output_path, inputs)) { return 1; }
+
+  for (const auto& input : inputs) {
+    SDL_Log(
+        "  %s: %u -> %u bytes",
+        input.name.c_str(),
+        input.uncompressed_size,
+        static_cast<uint32_t>(input.data.size()));
+  }
+
+  return 0;
+}
@@ -0,0 +1,7 @@
+// Bound while the pipeline of the selected shader is still being created. Kept trivial so that
+// its own pipeline can be created synchronously at startup without delaying the first frame.
+
+float4 main(float2 tex_coord : TEXCOORD0) : SV_Target {
+  float shade = lerp(0.02, 0.06, tex_coord.y);
+  return float4(shade, shade, shade, 1.0);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+// The plasma and hearts shared by the fragment (plasma_beat.hlsl) and compute
+// (plasma_beat_compute.hlsl) versions. Everything that is the same for every pixel of a frame is
+// computed on the CPU, by plasma_beat_prepare in shader_prepare.cpp.
+
+#include "common.hlsl"
+
+static const float PI                    = 3.1415926535897932384626433832795;
+static const float TWO_PI                = PI * 2.0;
+static const uint  RING_HEARTS_MAX_COUNT = 64;
+static const float RING_HEART_SIZE       = 0.08;
+
+// Matches the Plasma_Beat_Uniforms in shader_prepare.cpp.
+cbuffer Plasma_Beat_Uniforms : register(b1, UNIFORM_SPACE) {
+  float2 plasma_cos_sin : packoffset(c0);            // Of the rotation of the plasma.
+  float  pulse_phase : packoffset(c0.z);             // Of the beat, the same for both pulses.
+  float  centre_pulse_amplitude : packoffset(c0.w);  // Of the heart at the centre.
+  float  ring_pulse_amplitude : packoffset(c1);      // Of the radius of the heart ring.
+  uint   ring_hearts_count : packoffset(c1.y);
+  float  ring_heart_bounds_radius : packoffset(c1.z);  // The same for every heart.
+  // The cos and sin of the angle of each heart of the ring in xy and the centre of its bounding
+  // circle in zw, and its colour.
+  float4 ring_hearts[RING_HEARTS_MAX_COUNT] : packoffset(c2);
+  float4 ring_heart_colors[RING_HEARTS_MAX_COUNT] : packoffset(c66);
+};
+
+// cos_sin is (cos(angle), sin(angle)).
+float2 rotate(float2 p, float2 cos_sin) {
+  return float2(cos_sin.x * p.x + cos_sin.y * p.y, -cos_sin.y * p.x + cos_sin.x * p.y);
+}
+
+float heart(float2 p, float2 center, float size, float2 cos_sin) {
+  float2 o  = (p - center) / (1.6 * size);
+  float2 ro = rotate(o, cos_sin);
+  float  a  = ro.x * ro.x + ro.y * ro.y - 0.3;
+
+  return step(a * a * a * 2.0, ro.x * ro.x * ro.y * ro.y * ro.y);
+}
+
+float heart(float2 p, float2 center, float size, float angle) {
+  return heart(p, center, size, float2(cos(angle), sin(angle)));
+}
+
+// Modified plasma effect from https://www.bidouille.org/prog/plasma
+float3 plasma(float2 p, float scale) {
+  float2 rp = rotate(p, plasma_cos_sin) * scale;
+
+  float v1 = sin(rp.x + time);
+  float v2 = sin(rp.y + time);
+  float v3 = sin(rp.x + rp.y + time);
+  float v4 = sin(length(rp) + 1.7 * time);
+  float v  = v1 + v2 + v3 + v4;
+
+  v *= 2.0;
+  float3 color = float3(1.0, 0.3 - sin(v + PI * .5) * 0.2, 0.8 - sin(v + PI * .5) * 0.2);
+  return color * 0.5 + 0.5;
+}
+
+float2 get_uv(float2 frag_coord) {
+  return (2.0 * float2(frag_coord - 0.5 * resolution)) / resolution.y;
+}
+
+// The plasma and the centre heart. Returns the radius of the rotating heart ring at uv, which the
+// callers draw on top.
+float3 background(float2 uv, out float ring_radius) {
+  float  pulse = 1.0 + centre_pulse_amplitude * sin(pulse_phase + uv.y * 0.5);
+  float3 color = plasma(uv, pulse * 8.0);
+
+  // Centre heart.
+  float  radius      = pulse * 0.4;
+  float  d           = heart(uv, float2(0, -0.07), radius, 0.0);
+  float3 heart_color = lerp(float3(1.0, 1.0, 1.0), float3(0.95, 0.37, 0.47), pulse);
+  color              = lerp(color, heart_color, d);
+
+  pulse       = 0.4 + ring_pulse_amplitude * sin(pulse_phase + uv.x * 0.6);
+  ring_radius = 0.25 + pulse;
+
+  return color;
+}
+
+// Whether the bounding circle of the ring heart overlaps the box, which it does for every box that
+// the heart covers a point of. A point is a box with min == max.
+bool ring_heart_bounds_overlap(uint i, float2 box_min, float2 box_max) {
+  float2 centre = ring_hearts[i].zw;
+  float2 d      = clamp(centre, box_min, box_max) - centre;
+  return dot(d, d) <= ring_heart_bounds_radius * ring_heart_bounds_radius;
+}
+
+float3 draw_ring_heart(float3 color, uint i, float2 uv, float ring_radius) {
+  float2 cos_sin = ring_hearts[i].xy;
+  float  d       = heart(uv, ring_radius * cos_sin, RING_HEART_SIZE, cos_sin);
+  return lerp(color, ring_heart_colors[i].rgb, d);
+}
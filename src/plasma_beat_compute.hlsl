@@ -0,0 +1,55 @@
+// Compute version of plasma_beat.hlsl, one pixel per thread in 8x8 tiles. The hearts of the ring
+// and everything else that is the same for every pixel come from the uniforms, as in the fragment
+// version. Rather than every pixel testing the bounds of every heart, the threads of a tile first
+// bin the hearts whose bounds overlap the tile, a heart per thread, and each pixel then only draws
+// those.
+
+#include "plasma_beat_common.hlsl"
+
+static const uint TILE_SIZE             = 8;
+static const uint TILE_THREADS_COUNT    = TILE_SIZE * TILE_SIZE;
+static const uint TILE_HEART_MASK_WORDS = RING_HEARTS_MAX_COUNT / 32;
+
+[[vk::image_format("rgba8")]]
+RWTexture2D<float4> output_texture : register(u0, space1);
+
+// A bit per heart of the ring, set when its bounds overlap the tile.
+groupshared uint tile_heart_mask[TILE_HEART_MASK_WORDS];
+
+[numthreads(TILE_SIZE, TILE_SIZE, 1)]
+void main(uint3 id : SV_DispatchThreadID, uint3 group_id : SV_GroupID, uint index : SV_GroupIndex) {
+  if (index < TILE_HEART_MASK_WORDS) { tile_heart_mask[index] = 0; }
+  GroupMemoryBarrierWithGroupSync();
+
+  // get_uv increases with both coordinates, so the corners of the tile bound it.
+  float2 tile_min = get_uv(float2(group_id.xy * TILE_SIZE));
+  float2 tile_max = get_uv(float2(group_id.xy * TILE_SIZE + TILE_SIZE));
+  for (uint i = index; i < ring_hearts_count; i += TILE_THREADS_COUNT) {
+    if (ring_heart_bounds_overlap(i, tile_min, tile_max)) {
+      InterlockedOr(tile_heart_mask[i / 32], 1u << (i % 32));
+    }
+  }
+  GroupMemoryBarrierWithGroupSync();
+
+  // Only after the barriers, which every thread of the tile has to reach.
+  if (any(id.xy >= uint2(resolution))) { return; }
+
+  float2 uv = get_uv(float2(id.xy) + 0.5);
+
+  float  ring_radius;
+  float3 color = background(uv, ring_radius);
+
+  // Rotating heart ring, in order so that overlapping hearts draw as in the fragment version.
+  for (uint word = 0; word < TILE_HEART_MASK_WORDS; word++) {
+    uint mask = tile_heart_mask[word];
+    while (mask != 0) {
+      uint i = word * 32 + firstbitlow(mask);
+      mask &= mask - 1;
+      color = draw_ring_heart(color, i, uv, ring_radius);
+    }
+  }
+
+  color = pow(color, float3(2.2, 2.2, 2.2));
+
+  output_texture[id.xy] = float4(color, 1.0);
+}
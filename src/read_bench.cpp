@@ -0,0 +1,158 @@
+// Microbenchmark comparing the ways resources can be read from disk:
+//
+//   vector  read_storage_file into a std::vector (zero fills before reading)
+//   arena   read_storage_file into an Arena (no zero fill, no allocation once warm)
+//   mmap    map_file (zero copy, pages faulted in on first touch)
+//
+// Each method reads every test file a number of times and the best throughput is reported, so the
+// numbers mostly reflect the page cache rather than the disk.
+//
+// Usage: read_bench [-d <dir>] [-n <iterations>]
+
+// -- External Header Includes ------------------------------------------------
+#include <SDL3/SDL.h>
+
+// -- Platform Header Includes ------------------------------------------------
+#ifdef SDL_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// -- Std Header Includes -----------------------------------------------------
+#include <new>
+#include <string>
+#include <vector>
+
+// -- Local Source Includes ---------------------------------------------------
+#include "common.cpp"
+
+static constexpr size_t BENCH_FILE_SIZES_MB[] = {1, 4, 16, 64, 100};
+static constexpr size_t BENCH_PAGE_SIZE       = 4096;
+
+// Touches one byte per page so that every method pays for faulting the memory in.
+static uint64_t touch_pages(const uint8_t* data, size_t size) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < size; i += BENCH_PAGE_SIZE) { sum += data[i]; }
+
+  return sum;
+}
+
+static bool write_test_file(SDL_Storage* storage, const char* file_name, size_t size) {
+  std::vector<uint8_t> contents(size);
+  uint64_t             state = hash_string(file_name);
+  for (size_t i = 0; i < size; i++) {
+    state       = state * 6364136223846793005ull + 1442695040888963407ull;
+    contents[i] = static_cast<uint8_t>(state >> 56);
+  }
+
+  return SDL_WriteStorageFile(storage, file_name, contents.data(), contents.size());
+}
+
+static double bytes_per_second(size_t size, Uint64 ticks) {
+  return static_cast<double>(size) * SDL_GetPerformanceFrequency() / SDL_max(ticks, Uint64(1));
+}
+
+int main(int argc, char* argv[]) {
+  const char* dir_path   = nullptr;
+  int         iterations = 5;
+  for (int i = 1; i < argc; i++) {
+    if (SDL_strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+      dir_path = argv[++i];
+    } else if (SDL_strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      iterations = SDL_max(SDL_atoi(argv[++i]), 1);
+    } else {
+      SDL_Log("Usage: %s [-d <dir>] [-n <iterations>]", argv[0]);
+      return 1;
+    }
+  }
+
+  std::string base_path = dir_path != nullptr ? dir_path : SDL_GetBasePath();
+  if (!base_path.empty() && base_path.back() != '/' && base_path.back() != '\\') {
+    base_path += '/';
+  }
+
+  auto storage = SDL_OpenFileStorage(base_path.c_str());
+  if (storage == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to open storage: %s", SDL_GetError());
+    return 1;
+  }
+  defer(SDL_CloseStorage(storage));
+  while (!SDL_StorageReady(storage)) { SDL_Delay(1); }
+
+  // arena_reset only keeps the first block, so it has to fit the largest file (and the alignment
+  // padding) for the arena to be reused across sizes rather than allocating per read.
+  size_t max_size_mb = 0;
+  for (auto size_mb : BENCH_FILE_SIZES_MB) { max_size_mb = SDL_max(max_size_mb, size_mb); }
+  Arena arena      = {};
+  arena.block_size = max_size_mb * 1024 * 1024 + 16;
+  defer(arena_destroy(&arena));
+
+  uint64_t checksum = 0;
+  SDL_Log("%-10s %14s %14s %14s", "size", "vector MB/s", "arena MB/s", "mmap MB/s");
+  for (auto size_mb : BENCH_FILE_SIZES_MB) {
+    char file_name[64];
+    SDL_snprintf(file_name, sizeof(file_name), "read_bench_%zu.bin", size_mb);
+    auto file_size = size_mb * 1024 * 1024;
+    if (!write_test_file(storage, file_name, file_size)) {
+      SDL_LogError(
+          SDL_LOG_CATEGORY_APPLICATION,
+          "Failed to write %s: %s",
+          file_name,
+          SDL_GetError());
+      return 1;
+    }
+    defer(SDL_RemoveStoragePath(storage, file_name));
+    auto file_path = base_path + file_name;
+
+    Uint64 best_vector = UINT64_MAX;
+    Uint64 best_arena  = UINT64_MAX;
+    Uint64 best_mmap   = UINT64_MAX;
+    for (int i = 0; i < iterations; i++) {
+      auto start = SDL_GetPerformanceCounter();
+      {
+        std::vector<uint8_t> contents;
+        if (!read_storage_file(storage, file_name, &contents)) { return 1; }
+        checksum += touch_pages(contents.data(), contents.size());
+      }
+      best_vector = SDL_min(best_vector, SDL_GetPerformanceCounter() - start);
+
+      start = SDL_GetPerformanceCounter();
+      {
+        Byte_Span span;
+        if (!read_storage_file(storage, file_name, &arena, &span)) { return 1; }
+        checksum += touch_pages(span.data, span.size);
+        arena_reset(&arena);
+      }
+      best_arena = SDL_min(best_arena, SDL_GetPerformanceCounter() - start);
+
+      start = SDL_GetPerformanceCounter();
+      {
+        Mapped_File file = {};
+        if (!map_file(file_path.c_str(), &file)) { return 1; }
+        checksum += touch_pages(file.data, file.size);
+        unmap_file(&file);
+      }
+      best_mmap = SDL_min(best_mmap, SDL_GetPerformanceCounter() - start);
+    }
+
+    SDL_Log(
+        "%7zu MB %14.1f %14.1f %14.1f",
+        size_mb,
+        bytes_per_second(file_size, best_vector) / (1024.0 * 1024.0),
+        bytes_per_second(file_size, best_arena) / (1024.0 * 1024.0),
+        bytes_per_second(file_size, best_mmap) / (1024.0 * 1024.0));
+  }
+
+  // Printed so the reads can't be optimised away.
+  SDL_Log("checksum: %016llx", static_cast<unsigned long long>(checksum));
+
+  return 0;
+}
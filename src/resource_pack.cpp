@@ -0,0 +1,194 @@
+// -- Resource Pack -----------------------------------------------------------
+//
+// A resource pack is a single file holding every compiled resource of a release build:
+//
+//   Resource_Pack_Header
+//   Resource_Pack_Entry[entries_count]
+//   entry data, each starting on a RESOURCE_PACK_ALIGNMENT boundary
+//
+// It is written at build time by pack_resources.cpp and memory mapped at run time, so uncompressed
+// entries can be handed to the GPU API straight out of the mapping. Entries may optionally be
+// compressed with an LZ4 compatible block format, trading a copy for less disk I/O.
+
+static constexpr uint32_t    RESOURCE_PACK_MAGIC         = 0x4b415052;  // "RPAK"
+static constexpr uint32_t    RESOURCE_PACK_VERSION       = 1;
+static constexpr uint32_t    RESOURCE_PACK_ALIGNMENT     = 64;
+static constexpr int         RESOURCE_PACK_MAX_NAME_SIZE = 48;
+static constexpr uint32_t    RESOURCE_PACK_FLAG_LZ4      = 1 << 0;
+static constexpr const char* RESOURCE_PACK_FILE_PATH     = "res/resources.pak";
+
+struct Resource_Pack_Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entries_count;
+  uint32_t reserved;
+};
+
+struct Resource_Pack_Entry {
+  char     name[RESOURCE_PACK_MAX_NAME_SIZE];
+  uint64_t offset;
+  uint32_t size;
+  uint32_t uncompressed_size;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(Resource_Pack_Header) == 16, "Resource_Pack_Header layout changed");
+static_assert(sizeof(Resource_Pack_Entry) == 72, "Resource_Pack_Entry layout changed");
+
+// -- LZ4 Block Codec ---------------------------------------------------------
+//
+// A small greedy compressor and a bounds checked decompressor for the LZ4 block format. The
+// compressor favours simplicity over ratio; it only runs at build time.
+
+static constexpr int LZ4_MIN_MATCH     = 4;
+static constexpr int LZ4_LAST_LITERALS = 5;
+static constexpr int LZ4_MATCH_LIMIT   = 12;
+static constexpr int LZ4_MAX_OFFSET    = 65535;
+static constexpr int LZ4_HASH_BITS     = 12;
+
+static uint32_t lz4_read32(const uint8_t* ptr) {
+  uint32_t value;
+  SDL_memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+static void lz4_write_length(std::vector<uint8_t>* out, size_t length) {
+  while (length >= 255) {
+    out->push_back(255);
+    length -= 255;
+  }
+  out->push_back(static_cast<uint8_t>(length));
+}
+
+static void lz4_write_sequence(
+    std::vector<uint8_t>* out,
+    const uint8_t*        literals,
+    size_t                literals_size,
+    size_t                offset,
+    size_t                match_size) {
+  auto    match_extra = match_size >= LZ4_MIN_MATCH ? match_size - LZ4_MIN_MATCH : 0;
+  uint8_t token       = static_cast<uint8_t>(SDL_min(literals_size, size_t(15)) << 4);
+  if (match_size > 0) { token |= static_cast<uint8_t>(SDL_min(match_extra, size_t(15))); }
+  out->push_back(token);
+  if (literals_size >= 15) { lz4_write_length(out, literals_size - 15); }
+  out->insert(out->end(), literals, literals + literals_size);
+
+  if (match_size == 0) { return; }
+  out->push_back(static_cast<uint8_t>(offset & 0xff));
+  out->push_back(static_cast<uint8_t>(offset >> 8));
+  if (match_extra >= 15) { lz4_write_length(out, match_extra - 15); }
+}
+
+static void lz4_compress(const uint8_t* src, size_t src_size, std::vector<uint8_t>* out) {
+  std::vector<uint32_t> table(size_t(1) << LZ4_HASH_BITS, UINT32_MAX);
+
+  size_t anchor = 0;
+  size_t i      = 0;
+  while (i + LZ4_MATCH_LIMIT < src_size) {
+    auto sequence = lz4_read32(src + i);
+    auto hash     = (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+    auto ref      = table[hash];
+    table[hash]   = static_cast<uint32_t>(i);
+
+    if (ref == UINT32_MAX || i - ref > LZ4_MAX_OFFSET || lz4_read32(src + ref) != sequence) {
+      i += 1;
+      continue;
+    }
+
+    size_t match_size  = LZ4_MIN_MATCH;
+    size_t match_limit = src_size - LZ4_LAST_LITERALS;
+    while (i + match_size < match_limit && src[ref + match_size] == src[i + match_size]) {
+      match_size += 1;
+    }
+
+    lz4_write_sequence(out, src + anchor, i - anchor, i - ref, match_size);
+    i += match_size;
+    anchor = i;
+  }
+
+  lz4_write_sequence(out, src + anchor, src_size - anchor, 0, 0);
+}
+
+static bool lz4_read_length(const uint8_t** ptr, const uint8_t* end, size_t* length) {
+  uint8_t byte;
+  do {
+    if (*ptr >= end) { return false; }
+    byte = **ptr;
+    *ptr += 1;
+    *length += byte;
+  } while (byte == 255);
+
+  return true;
+}
+
+static bool lz4_decompress(const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size) {
+  auto ip      = src;
+  auto src_end = src + src_size;
+  auto op      = dst;
+  auto dst_end = dst + dst_size;
+
+  while (ip < src_end) {
+    auto token = *ip++;
+
+    size_t literals_size = token >> 4;
+    if (literals_size == 15 && !lz4_read_length(&ip, src_end, &literals_size)) { return false; }
+    if (literals_size > static_cast<size_t>(src_end - ip)) { return false; }
+    if (literals_size > static_cast<size_t>(dst_end - op)) { return false; }
+    SDL_memcpy(op, ip, literals_size);
+    ip += literals_size;
+    op += literals_size;
+    if (ip == src_end) { break; }
+
+    if (src_end - ip < 2) { return false; }
+    size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<size_t>(op - dst)) { return false; }
+
+    size_t match_size = token & 15;
+    if (match_size == 15 && !lz4_read_length(&ip, src_end, &match_size)) { return false; }
+    match_size += LZ4_MIN_MATCH;
+    if (match_size > static_cast<size_t>(dst_end - op)) { return false; }
+
+    // Matches may overlap the bytes being written, so copy one byte at a time.
+    auto match = op - offset;
+    for (size_t i = 0; i < match_size; i++) { op[i] = match[i]; }
+    op += match_size;
+  }
+
+  return op == dst_end;
+}
+
+// -- Resource Pack Reading ---------------------------------------------------
+
+static bool resource_pack_validate(const uint8_t* data, size_t size) {
+  if (size < sizeof(Resource_Pack_Header)) { return false; }
+
+  Resource_Pack_Header header;
+  SDL_memcpy(&header, data, sizeof(header));
+  if (header.magic != RESOURCE_PACK_MAGIC || header.version != RESOURCE_PACK_VERSION) {
+    return false;
+  }
+
+  auto toc_size = static_cast<size_t>(header.entries_count) * sizeof(Resource_Pack_Entry);
+  if (toc_size > size - sizeof(header)) { return false; }
+
+  auto entries = reinterpret_cast<const Resource_Pack_Entry*>(data + sizeof(header));
+  for (uint32_t i = 0; i < header.entries_count; i++) {
+    const auto& entry = entries[i];
+    if (entry.offset > size || entry.size > size - entry.offset) { return false; }
+    if (entry.name[RESOURCE_PACK_MAX_NAME_SIZE - 1] != '\0') { return false; }
+  }
+
+  return true;
+}
+
+static const Resource_Pack_Entry* resource_pack_find(const uint8_t* data, const char* name) {
+  auto header  = reinterpret_cast<const Resource_Pack_Header*>(data);
+  auto entries = reinterpret_cast<const Resource_Pack_Entry*>(data + sizeof(*header));
+  for (uint32_t i = 0; i < header->entries_count; i++) {
+    if (SDL_strcmp(entries[i].name, name) == 0) { return &entries[i]; }
+  }
+
+  return nullptr;
+}
@@ -1,12 +1,36 @@
-enum Resource_ID {
-  RESOURCE_ID_SHADER_VERTEX_FULLSCREEN,
-  RESOURCE_ID_SHADER_FRAGMENT_FBM_WARP,
-  RESOURCE_ID_SHADER_FRAGMENT_PLASMA_BEAT,
-  RESOURCE_ID_COUNT,
-};
-
 enum Resource_Kind {
   RESOURCE_KIND_SHADER,
+  RESOURCE_KIND_COMPUTE_PIPELINE,  // SDL GPU has no compute shader objects, only pipelines.
+  RESOURCE_KIND_TEXTURE,           // Generated at startup, by the generator of the same name.
+};
+
+// Binding counts the GPU API needs to create a shader. Release builds take them from the table
+// generated at build time, debug builds reflect them from every compile.
+struct Shader_Bindings {
+  int samplers_count;
+  int storage_textures_count;
+  int storage_buffers_count;
+  int uniform_buffers_count;
+};
+
+// Binding counts and workgroup size the GPU API needs to create a compute pipeline, sourced like
+// Shader_Bindings.
+struct Compute_Bindings {
+  int samplers_count;
+  int readonly_storage_textures_count;
+  int readonly_storage_buffers_count;
+  int readwrite_storage_textures_count;
+  int readwrite_storage_buffers_count;
+  int uniform_buffers_count;
+  int threadcount_x;
+  int threadcount_y;
+  int threadcount_z;
+};
+
+// Everything reflected from a compiled shader, whichever kind of resource it is for.
+struct Shader_Reflection {
+  Shader_Bindings  bindings;
+  Compute_Bindings compute_bindings;
 };
 
 struct Resource_Info {
@@ -14,139 +38,805 @@ struct Resource_Info {
   const char*   file_name;
   struct {
     SDL_GPUShaderStage stage;
-    int                samplers_count;
-    int                storage_textures_count;
-    int                storage_buffers_count;
-    int                uniform_buffers_count;
+    Shader_Bindings    bindings;
   } shader;
+  struct {
+    Compute_Bindings bindings;
+  } compute;
 };
 
+// A shader can declare up to SHADER_PERMUTATION_MAX_AXES permutation axes in the shader lists of
+// the build scripts, each a define that its source checks with #ifdef. A variant of the shader is
+// keyed by a mask with bit i set when axis i is defined. Variant 0 defines none of them and is
+// loaded at startup, the others the first time they are asked for: compiled by SDL_shadercross in
+// debug builds, and read from their own file (compiled by the build scripts) in release builds.
+// Variants must have the same bindings as variant 0, which gen_resources checks.
+typedef uint32_t Shader_Variant_Mask;
+
+static constexpr int SHADER_PERMUTATION_MAX_AXES = 4;
+static constexpr int SHADER_VARIANTS_MAX         = 1 << SHADER_PERMUTATION_MAX_AXES;
+
+// The define of each axis, null past the last one.
+typedef std::array<const char*, SHADER_PERMUTATION_MAX_AXES> Shader_Permutation_Axes;
+
+// Defines Resource_ID, RESOURCES_INFO and RESOURCES_PERMUTATION_AXES. Generated by
+// gen_resources.cpp from the shader and texture lists in the build scripts, so adding a shader
+// doesn't need any C++ edits.
+#include "resources_info.cpp"
+
+static constexpr int shader_permutation_axes_count(const Shader_Permutation_Axes& axes) {
+  int count = 0;
+  while (count < SHADER_PERMUTATION_MAX_AXES && axes[count] != nullptr) { count += 1; }
+  return count;
+}
+
+static constexpr int RESOURCE_MAX_PATH_SIZE = 64;
+
+#ifndef BUILD_DEBUG
+// Matches the variant file names gen_resources writes for the build scripts.
+static void shader_variant_file_name(
+    const char*         file_name,
+    Shader_Variant_Mask mask,
+    char*               out_name,
+    size_t              out_name_size) {
+  if (mask == 0) {
+    SDL_snprintf(out_name, out_name_size, "%s", file_name);
+  } else {
+    SDL_snprintf(out_name, out_name_size, "%s_p%u", file_name, mask);
+  }
+}
+#endif
+
 struct Resource {
   Resource_Kind kind;
-  std::string   file_path;
-  SDL_Time      last_modify_time;
+  char          file_path[RESOURCE_MAX_PATH_SIZE];
+#ifdef BUILD_DEBUG
+  uint64_t source_hash;  // Hash of the preprocessed source the resource was compiled from.
+#endif
   struct {
-    SDL_GPUShader* handle;
+    SDL_GPUShader*  handle;
+    Shader_Bindings bindings;
   } shader;
+  struct {
+    SDL_GPUComputePipeline* handle;
+    Compute_Bindings        bindings;
+  } compute;
+  struct {
+    SDL_GPUTexture* handle;
+  } texture;
+};
+
+#ifdef BUILD_DEBUG
+enum Shader_Compile_State {
+  SHADER_COMPILE_STATE_IDLE,
+  SHADER_COMPILE_STATE_QUEUED,
+  SHADER_COMPILE_STATE_RUNNING,
+  SHADER_COMPILE_STATE_DONE,
+};
+
+// Allocated from the arena of the job that preprocessed it.
+struct Shader_Source {
+  Arena_String               source;    // With every #include expanded.
+  Arena_Vector<Arena_String> includes;  // Storage paths of every file included, directly or not.
+  uint64_t                   hash;
+};
+
+// A file #included by one or more shaders. Changes to it are reported by the file watcher with
+// the id RESOURCE_ID_COUNT + its index in Resources::shader_includes.
+struct Shader_Include {
+  std::string                         file_path;
+  std::array<bool, RESOURCE_ID_COUNT> dependents;
+};
+
+// A live reload compile. The inputs are written by the main thread before the job is queued and
+// the outputs are only read by the main thread once the state has become DONE. Everything the job
+// allocates comes from its scratch arena, which is reset when the next compile is submitted.
+struct Shader_Compile_Job {
+  SDL_Storage*                storage;
+  Shader_Cache*               cache;
+  SDL_GPUShaderFormat         format;
+  SDL_ShaderCross_ShaderStage stage;
+  char                        file_path[RESOURCE_MAX_PATH_SIZE];
+  uint64_t                    previous_source_hash;
+  Arena                       scratch;
+  Shader_Source               source;
+  Shader_Reflection           reflection;
+  Byte_Span                   code;
+  bool                        preprocessed;
+  bool                        unchanged;  // The preprocessed source matched, so nothing compiled.
+  bool                        succeeded;
+  Uint64                      start_ticks;
+  SDL_AtomicInt               state;
+  bool                        pending;  // The file changed again while the job was in flight.
+};
+#endif
+
+struct Resource_Data {
+  // Points either into the memory mapped resource pack or into the arena the data was read with.
+  const uint8_t* bytes;
+  size_t         bytes_size;
+#ifdef BUILD_DEBUG
+  Shader_Source     shader_source;
+  Shader_Reflection shader_reflection;  // Of the compiled shader.
+#endif
+};
+
+enum Shader_Variant_State {
+  SHADER_VARIANT_STATE_EMPTY,
+  SHADER_VARIANT_STATE_PENDING,  // Being read (and compiled) on the job pool.
+  SHADER_VARIANT_STATE_DONE,     // Read, waiting for the main thread to create it.
+  SHADER_VARIANT_STATE_READY,
+  SHADER_VARIANT_STATE_FAILED,  // Not retried until the shader is reloaded.
+};
+
+struct Resources;
+
+// A variant other than 0 of a shader or compute pipeline resource. The job inputs are written by
+// the main thread before the job is queued and the outputs are only read by the main thread once
+// the state has become DONE. The data is read into the arena, which is reset by the next load.
+struct Shader_Variant {
+  Resource            resource;  // Created once READY.
+  SDL_AtomicInt       state;
+  bool                outdated;  // The shader was reloaded while the job was in flight.
+  Resources*          resources;
+  SDL_Storage*        storage;
+  Resource_ID         id;
+  Shader_Variant_Mask mask;
+  Arena               arena;
+  Resource_Data       data;
+  bool                succeeded;
+  Uint64              start_ticks;
 };
 
 struct Resources {
   std::array<Resource, RESOURCE_ID_COUNT> items;
   SDL_GPUShaderFormat                     shader_format;
   const char*                             shader_file_ext;
-  SDL_Time                                last_time;
+
+  // Indexed by resource id and then variant mask. Variant 0 is the one in items, and unused here.
+  std::array<std::array<Shader_Variant, SHADER_VARIANTS_MAX>, RESOURCE_ID_COUNT> variants;
+
+#ifdef BUILD_DEBUG
+  File_Watcher                                      watcher;
+  Shader_Cache                                      shader_cache;
+  std::vector<Shader_Include>                       shader_includes;
+  std::array<Shader_Compile_Job, RESOURCE_ID_COUNT> compile_jobs;
+#else
+  Mapped_File pack;
+#endif
 };
 
-static constexpr auto RESOURCES_INFO = []() {
-  std::array<Resource_Info, RESOURCE_ID_COUNT> result = {};
-  {
-    auto info          = &result[RESOURCE_ID_SHADER_VERTEX_FULLSCREEN];
-    info->kind         = RESOURCE_KIND_SHADER;
-    info->file_name    = "fullscreen";
-    info->shader.stage = SDL_GPU_SHADERSTAGE_VERTEX;
+#ifdef BUILD_DEBUG
+// The defines of a variant, on top of the <STAGE>_SHADER one.
+struct Shader_Variant_Defines {
+  Shader_Permutation_Axes names;
+  int                     count;
+};
+
+static Shader_Variant_Defines shader_variant_defines(Resource_ID id, Shader_Variant_Mask mask) {
+  const auto& axes = RESOURCES_PERMUTATION_AXES[id];
+
+  Shader_Variant_Defines defines = {};
+  for (int i = 0; i < shader_permutation_axes_count(axes); i++) {
+    if ((mask & (1u << i)) == 0) { continue; }
+    defines.names[defines.count] = axes[i];
+    defines.count += 1;
   }
-  {
-    auto info                          = &result[RESOURCE_ID_SHADER_FRAGMENT_FBM_WARP];
-    info->kind                         = RESOURCE_KIND_SHADER;
-    info->file_name                    = "fbm_warp";
-    info->shader.stage                 = SDL_GPU_SHADERSTAGE_FRAGMENT;
-    info->shader.uniform_buffers_count = 1;
+  return defines;
+}
+
+static constexpr int SHADER_MAX_INCLUDE_DEPTH = 16;
+
+// Expands #include "..." directives (relative to the including file) so the compiler only ever
+// sees a single source string, and records every file that was pulled in. Each file is only
+// included once, as if it started with #pragma once.
+static bool shader_preprocess_file(
+    SDL_Storage*   storage,
+    Arena*         scratch,
+    const char*    file_path,
+    int            depth,
+    Shader_Source* out_source) {
+  if (depth > SHADER_MAX_INCLUDE_DEPTH) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to preprocess %s: includes nest too deep",
+        file_path);
+    return false;
   }
-  {
-    auto info                          = &result[RESOURCE_ID_SHADER_FRAGMENT_PLASMA_BEAT];
-    info->kind                         = RESOURCE_KIND_SHADER;
-    info->file_name                    = "plasma_beat";
-    info->shader.stage                 = SDL_GPU_SHADERSTAGE_FRAGMENT;
-    info->shader.uniform_buffers_count = 1;
+
+  Byte_Span file_span;
+  if (!read_storage_file(storage, file_path, scratch, &file_span)) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to read file contents: %s", file_path);
+    return false;
+  }
+  auto file_contents =
+      std::string_view(reinterpret_cast<const char*>(file_span.data), file_span.size);
+
+  auto dir_path  = Arena_String(file_path, scratch);
+  auto separator = dir_path.find_last_of('/');
+  dir_path.resize(separator == Arena_String::npos ? 0 : separator + 1);
+
+  int    line_number = 1;
+  size_t line_start  = 0;
+  while (line_start < file_contents.size()) {
+    auto line_end = file_contents.find('\n', line_start);
+    if (line_end == std::string_view::npos) { line_end = file_contents.size(); }
+    auto line  = file_contents.substr(line_start, line_end - line_start);
+    line_start = line_end + 1;
+    line_number += 1;
+
+    auto directive_start = line.find_first_not_of(" \t");
+    auto directive       = directive_start == std::string_view::npos ? std::string_view()
+                                                                     : line.substr(directive_start);
+    if (directive.substr(0, 12) == "#pragma once") { continue; }
+    if (directive.substr(0, 8) != "#include") {
+      out_source->source.append(line);
+      out_source->source += '\n';
+      continue;
+    }
+
+    auto name_start = directive.find('"');
+    auto name_end   = directive.find('"', name_start + 1);
+    if (name_start == std::string_view::npos || name_end == std::string_view::npos) {
+      SDL_LogError(
+          SDL_LOG_CATEGORY_APPLICATION,
+          "Failed to preprocess %s:%d: expected #include \"file\"",
+          file_path,
+          line_number - 1);
+      return false;
+    }
+    auto include_path = dir_path;
+    include_path.append(directive.substr(name_start + 1, name_end - name_start - 1));
+
+    auto& includes = out_source->includes;
+    if (std::find(includes.begin(), includes.end(), include_path) != includes.end()) { continue; }
+    includes.push_back(include_path);
+
+    char line_marker[512];
+    SDL_snprintf(line_marker, sizeof(line_marker), "#line 1 \"%s\"\n", include_path.c_str());
+    out_source->source += line_marker;
+    if (!shader_preprocess_file(storage, scratch, include_path.c_str(), depth + 1, out_source)) {
+      return false;
+    }
+    SDL_snprintf(line_marker, sizeof(line_marker), "#line %d \"%s\"\n", line_number, file_path);
+    out_source->source += line_marker;
+  }
+
+  return true;
+}
+
+static bool shader_preprocess(
+    SDL_Storage*   storage,
+    Arena*         scratch,
+    const char*    file_path,
+    Shader_Source* out_source) {
+  out_source->source   = Arena_String(scratch);
+  out_source->includes = Arena_Vector<Arena_String>(scratch);
+  if (!shader_preprocess_file(storage, scratch, file_path, 0, out_source)) { return false; }
+  out_source->hash = hash_bytes(out_source->source.data(), out_source->source.size());
+
+  return true;
+}
+
+static SDL_ShaderCross_ShaderStage resource_shader_stage(const Resource_Info& resource_info) {
+  if (resource_info.kind == RESOURCE_KIND_COMPUTE_PIPELINE) {
+    return SDL_SHADERCROSS_SHADERSTAGE_COMPUTE;
+  }
+  return resource_info.shader.stage == SDL_GPU_SHADERSTAGE_VERTEX
+             ? SDL_SHADERCROSS_SHADERSTAGE_VERTEX
+             : SDL_SHADERCROSS_SHADERSTAGE_FRAGMENT;
+}
+
+static bool shader_reflect_spirv(
+    const uint8_t*              code,
+    size_t                      code_size,
+    SDL_ShaderCross_ShaderStage stage,
+    Shader_Reflection*          out_reflection) {
+  *out_reflection = {};
+  if (stage == SDL_SHADERCROSS_SHADERSTAGE_COMPUTE) {
+    auto metadata = SDL_ShaderCross_ReflectComputeSPIRV(code, code_size, 0);
+    if (metadata == nullptr) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to reflect SPIRV: %s", SDL_GetError());
+      return false;
+    }
+    defer(SDL_free(metadata));
+
+    auto bindings                              = &out_reflection->compute_bindings;
+    bindings->samplers_count                   = metadata->num_samplers;
+    bindings->readonly_storage_textures_count  = metadata->num_readonly_storage_textures;
+    bindings->readonly_storage_buffers_count   = metadata->num_readonly_storage_buffers;
+    bindings->readwrite_storage_textures_count = metadata->num_readwrite_storage_textures;
+    bindings->readwrite_storage_buffers_count  = metadata->num_readwrite_storage_buffers;
+    bindings->uniform_buffers_count            = metadata->num_uniform_buffers;
+    bindings->threadcount_x                    = metadata->threadcount_x;
+    bindings->threadcount_y                    = metadata->threadcount_y;
+    bindings->threadcount_z                    = metadata->threadcount_z;
+
+    return true;
+  }
+
+  auto metadata = SDL_ShaderCross_ReflectGraphicsSPIRV(code, code_size, 0);
+  if (metadata == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to reflect SPIRV: %s", SDL_GetError());
+    return false;
   }
-  return result;
-}();
+  defer(SDL_free(metadata));
 
-static bool resource_load(
+  auto bindings                    = &out_reflection->bindings;
+  bindings->samplers_count         = metadata->resource_info.num_samplers;
+  bindings->storage_textures_count = metadata->resource_info.num_storage_textures;
+  bindings->storage_buffers_count  = metadata->resource_info.num_storage_buffers;
+  bindings->uniform_buffers_count  = metadata->resource_info.num_uniform_buffers;
+
+  return true;
+}
+
+// Compiles the shader and reflects its binding counts. Reflection works on SPIRV, so when the
+// target format is something else the source is compiled to SPIRV as well; both results end up
+// in the shader cache, so that only costs anything on a cache miss. The code is returned in memory
+// pushed onto the arena. Like the build scripts, defines <STAGE>_SHADER, followed by the defines of
+// the variant.
+static bool shader_compile_hlsl(
+    Shader_Cache*                 cache,
+    Arena*                        arena,
+    const Shader_Source&          source,
+    SDL_ShaderCross_ShaderStage   stage,
+    const Shader_Variant_Defines& variant_defines,
+    SDL_GPUShaderFormat           format,
+    Shader_Reflection*            out_reflection,
+    Byte_Span*                    out_code) {
+  static constexpr std::array<const char*, 3> STAGE_DEFINES = {
+      "VERTEX_SHADER",
+      "FRAGMENT_SHADER",
+      "COMPUTE_SHADER",
+  };
+  auto stage_define = STAGE_DEFINES[stage];
+
+  auto defines_key = Arena_String(stage_define, arena);
+  for (int i = 0; i < variant_defines.count; i++) {
+    defines_key += ' ';
+    defines_key += variant_defines.names[i];
+  }
+
+  Shader_Cache_Key cache_key = {};
+  cache_key.source           = source.source.c_str();
+  cache_key.source_size      = source.source.size();
+  cache_key.entrypoint       = "main";
+  cache_key.defines          = defines_key.c_str();
+  cache_key.stage            = stage;
+  cache_key.format           = format;
+  auto key                   = shader_cache_key_hash(cache_key);
+  if (shader_cache_read(cache, arena, key, out_reflection, sizeof(*out_reflection), out_code)) {
+    SDL_AddAtomicInt(&cache->hits, 1);
+    return true;
+  }
+  SDL_AddAtomicInt(&cache->misses, 1);
+  auto start_ticks = SDL_GetTicks();
+
+  // Terminated by an empty define.
+  std::array<SDL_ShaderCross_HLSL_Define, SHADER_PERMUTATION_MAX_AXES + 2> defines = {};
+  for (int i = 0; i < variant_defines.count; i++) {
+    defines[i + 1].name = const_cast<char*>(variant_defines.names[i]);
+  }
+  defines[0].name = const_cast<char*>(stage_define);
+
+  SDL_ShaderCross_HLSL_Info hlsl_info = {};
+  hlsl_info.source                    = source.source.c_str();
+  hlsl_info.entrypoint                = "main";
+  hlsl_info.defines                   = defines.data();
+  hlsl_info.shader_stage              = stage;
+  size_t spirv_size;
+  auto   spirv =
+      static_cast<uint8_t*>(SDL_ShaderCross_CompileSPIRVFromHLSL(&hlsl_info, &spirv_size));
+  if (spirv == nullptr) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to compile SPIRV from hlsl:\n%s",
+        SDL_GetError());
+    return false;
+  }
+  defer(SDL_free(spirv));
+  if (!shader_reflect_spirv(spirv, spirv_size, stage, out_reflection)) { return false; }
+
+  void*  data      = nullptr;
+  size_t data_size = 0;
+  switch (format) {
+  case SDL_GPU_SHADERFORMAT_DXIL: {
+    data = SDL_ShaderCross_CompileDXILFromHLSL(&hlsl_info, &data_size);
+    if (data == nullptr) {
+      SDL_LogError(
+          SDL_LOG_CATEGORY_APPLICATION,
+          "Failed to compile DXIL from hlsl:\n%s",
+          SDL_GetError());
+      return false;
+    }
+  } break;
+  case SDL_GPU_SHADERFORMAT_SPIRV: {
+    data      = spirv;
+    data_size = spirv_size;
+    spirv     = nullptr;
+  } break;
+  default:
+    SDL_assert(false);
+    return false;
+  }
+  defer(SDL_free(data));
+
+  auto code = static_cast<uint8_t*>(arena_push(arena, data_size));
+  if (code == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate shader code");
+    return false;
+  }
+  SDL_memcpy(code, data, data_size);
+  out_code->data = code;
+  out_code->size = data_size;
+
+  SDL_AddAtomicInt(&cache->compile_time_ms, static_cast<int>(SDL_GetTicks() - start_ticks));
+  shader_cache_write(cache, arena, key, out_reflection, sizeof(*out_reflection), *out_code);
+
+  return true;
+}
+
+static void shader_compile_job(void* user_data) {
+  auto job         = static_cast<Shader_Compile_Job*>(user_data);
+  job->start_ticks = SDL_GetTicks();
+  SDL_SetAtomicInt(&job->state, SHADER_COMPILE_STATE_RUNNING);
+
+  job->preprocessed = shader_preprocess(job->storage, &job->scratch, job->file_path, &job->source);
+  job->unchanged    = job->preprocessed && job->source.hash == job->previous_source_hash;
+  job->succeeded    = false;
+  if (job->preprocessed && !job->unchanged) {
+    job->succeeded = shader_compile_hlsl(
+        job->cache,
+        &job->scratch,
+        job->source,
+        job->stage,
+        {},
+        job->format,
+        &job->reflection,
+        &job->code);
+  }
+
+  SDL_SetAtomicInt(&job->state, SHADER_COMPILE_STATE_DONE);
+}
+
+static void shader_compile_job_submit(
+    Resources*   resources,
+    Job_Pool*    job_pool,
+    SDL_Storage* storage,
+    Resource_ID  id) {
+  auto job       = &resources->compile_jobs[id];
+  job->storage   = storage;
+  job->cache     = &resources->shader_cache;
+  job->format    = resources->shader_format;
+  job->stage     = resource_shader_stage(RESOURCES_INFO[id]);
+  job->pending   = false;
+  SDL_strlcpy(job->file_path, resources->items[id].file_path, sizeof(job->file_path));
+
+  job->previous_source_hash = resources->items[id].source_hash;
+  job->code                 = {};
+  job->source               = {};
+  arena_reset(&job->scratch);
+  SDL_SetAtomicInt(&job->state, SHADER_COMPILE_STATE_QUEUED);
+
+  job_pool_push(job_pool, shader_compile_job, job);
+}
+
+// Replaces the includes recorded for a shader, watching any include file that is new.
+static void resources_set_shader_includes(
+    Resources*                        resources,
+    Resource_ID                       id,
+    const Arena_Vector<Arena_String>& includes) {
+  for (auto& include : resources->shader_includes) { include.dependents[id] = false; }
+
+  for (const auto& include_path : includes) {
+    auto it = std::find_if(
+        resources->shader_includes.begin(),
+        resources->shader_includes.end(),
+        [&](const Shader_Include& include) {
+          return std::string_view(include.file_path) == std::string_view(include_path);
+        });
+    if (it == resources->shader_includes.end()) {
+      Shader_Include include = {};
+      include.file_path      = std::string(include_path.data(), include_path.size());
+      resources->shader_includes.push_back(include);
+      it = resources->shader_includes.end() - 1;
+
+      if (resources->watcher.thread != nullptr) {
+        auto include_index = it - resources->shader_includes.begin();
+        auto watch_id      = RESOURCE_ID_COUNT + static_cast<int>(include_index);
+        file_watcher_add(&resources->watcher, watch_id, include_path.c_str());
+      }
+    }
+    it->dependents[id] = true;
+  }
+}
+#endif
+
+static bool shader_create(
     Resources*           resources,
     Resource*            resource,
     SDL_GPUDevice*       device,
-    SDL_Storage*         storage,
-    const Resource_Info& resource_info) {
+    const Resource_Info& resource_info,
+    const uint8_t*       code,
+    size_t               code_size) {
+  SDL_GPUShaderCreateInfo info = {};
+  info.code                    = code;
+  info.code_size               = code_size;
+  info.entrypoint              = "main";
+  info.format                  = resources->shader_format;
+  info.num_samplers            = resource_info.shader.bindings.samplers_count;
+  info.num_storage_textures    = resource_info.shader.bindings.storage_textures_count;
+  info.num_storage_buffers     = resource_info.shader.bindings.storage_buffers_count;
+  info.num_uniform_buffers     = resource_info.shader.bindings.uniform_buffers_count;
+  info.stage                   = resource_info.shader.stage;
+  resource->shader.handle      = SDL_CreateGPUShader(device, &info);
+  if (resource->shader.handle == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create shader: %s", SDL_GetError());
+    return false;
+  }
+  resource->shader.bindings = resource_info.shader.bindings;
+
+  return true;
+}
+
+static bool compute_pipeline_create(
+    Resources*           resources,
+    Resource*            resource,
+    SDL_GPUDevice*       device,
+    const Resource_Info& resource_info,
+    const uint8_t*       code,
+    size_t               code_size) {
+  const auto& bindings = resource_info.compute.bindings;
+
+  SDL_GPUComputePipelineCreateInfo info = {};
+  info.code                             = code;
+  info.code_size                        = code_size;
+  info.entrypoint                       = "main";
+  info.format                           = resources->shader_format;
+  info.num_samplers                     = bindings.samplers_count;
+  info.num_readonly_storage_textures    = bindings.readonly_storage_textures_count;
+  info.num_readonly_storage_buffers     = bindings.readonly_storage_buffers_count;
+  info.num_readwrite_storage_textures   = bindings.readwrite_storage_textures_count;
+  info.num_readwrite_storage_buffers    = bindings.readwrite_storage_buffers_count;
+  info.num_uniform_buffers              = bindings.uniform_buffers_count;
+  info.threadcount_x                    = bindings.threadcount_x;
+  info.threadcount_y                    = bindings.threadcount_y;
+  info.threadcount_z                    = bindings.threadcount_z;
+  resource->compute.handle              = SDL_CreateGPUComputePipeline(device, &info);
+  if (resource->compute.handle == nullptr) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to create compute pipeline: %s",
+        SDL_GetError());
+    return false;
+  }
+  resource->compute.bindings = bindings;
+
+  return true;
+}
+
+// Uploads the texels on a command buffer of its own, which the GPU runs before anything submitted
+// after it.
+static bool texture_create(
+    Resource*            resource,
+    SDL_GPUDevice*       device,
+    const Resource_Info& resource_info,
+    const uint8_t*       texels,
+    size_t               texels_size) {
+  auto generator = texture_generator_find(resource_info.file_name);
+  SDL_assert(generator != nullptr);
+  SDL_assert(
+      texels_size ==
+      static_cast<size_t>(generator->width * generator->height * generator->bytes_per_texel));
+
+  SDL_GPUTextureCreateInfo info = {};
+  info.type                     = SDL_GPU_TEXTURETYPE_2D;
+  info.format                   = generator->format;
+  info.usage                    = SDL_GPU_TEXTUREUSAGE_SAMPLER;
+  info.width                    = generator->width;
+  info.height                   = generator->height;
+  info.layer_count_or_depth     = 1;
+  info.num_levels               = 1;
+  resource->texture.handle      = SDL_CreateGPUTexture(device, &info);
+  if (resource->texture.handle == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create texture: %s", SDL_GetError());
+    return false;
+  }
+
+  SDL_GPUTransferBufferCreateInfo transfer_info = {};
+  transfer_info.usage                           = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+  transfer_info.size                            = static_cast<Uint32>(texels_size);
+
+  auto transfer_buffer = SDL_CreateGPUTransferBuffer(device, &transfer_info);
+  if (transfer_buffer == nullptr) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to create transfer buffer: %s",
+        SDL_GetError());
+    return false;
+  }
+  defer(SDL_ReleaseGPUTransferBuffer(device, transfer_buffer));
+
+  auto mapped = SDL_MapGPUTransferBuffer(device, transfer_buffer, false);
+  if (mapped == nullptr) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to map transfer buffer: %s",
+        SDL_GetError());
+    return false;
+  }
+  SDL_memcpy(mapped, texels, texels_size);
+  SDL_UnmapGPUTransferBuffer(device, transfer_buffer);
+
+  auto cmd_buf = SDL_AcquireGPUCommandBuffer(device);
+  if (cmd_buf == nullptr) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to acquire command buffer: %s",
+        SDL_GetError());
+    return false;
+  }
+  auto copy_pass = SDL_BeginGPUCopyPass(cmd_buf);
+
+  SDL_GPUTextureTransferInfo source = {};
+  source.transfer_buffer            = transfer_buffer;
+
+  SDL_GPUTextureRegion destination = {};
+  destination.texture              = resource->texture.handle;
+  destination.w                    = generator->width;
+  destination.h                    = generator->height;
+  destination.d                    = 1;
+
+  SDL_UploadToGPUTexture(copy_pass, &source, &destination, false);
+  SDL_EndGPUCopyPass(copy_pass);
+  if (!SDL_SubmitGPUCommandBuffer(cmd_buf)) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to submit command buffer: %s",
+        SDL_GetError());
+    return false;
+  }
+
+  return true;
+}
+
+// Reads (and in debug builds compiles) the file backing a resource, or one of its variants. Doesn't
+// touch the GPU device or any other resource, so it is safe to run on a worker thread. Anything
+// read from disk is pushed onto the arena, which must outlive the returned data. In release builds
+// the file path of the resource is already that of the variant.
+static bool resource_read(
+    Resources*          resources,
+    const Resource&     resource,
+    SDL_Storage*        storage,
+    Arena*              arena,
+    Resource_ID         id,
+    Shader_Variant_Mask variant_mask,
+    Resource_Data*      out_data) {
+  const auto& resource_info = RESOURCES_INFO[id];
+
   switch (resource_info.kind) {
-  case RESOURCE_KIND_SHADER: {
-    std::vector<uint8_t> shader_code;
+  case RESOURCE_KIND_SHADER:
+  case RESOURCE_KIND_COMPUTE_PIPELINE: {
 #ifdef BUILD_DEBUG
-    resource->file_path = std::string("src/") + resource_info.file_name + ".hlsl";
-
-    std::string file_contents;
-    if (!read_storage_file(storage, resource->file_path.c_str(), &file_contents)) {
-      SDL_LogError(
-          SDL_LOG_CATEGORY_APPLICATION,
-          "Failed to read file contents: %s",
-          resource->file_path.c_str());
+    if (!shader_preprocess(storage, arena, resource.file_path, &out_data->shader_source)) {
+      return false;
+    }
+    Byte_Span code;
+    if (!shader_compile_hlsl(
+            &resources->shader_cache,
+            arena,
+            out_data->shader_source,
+            resource_shader_stage(resource_info),
+            shader_variant_defines(id, variant_mask),
+            resources->shader_format,
+            &out_data->shader_reflection,
+            &code)) {
       return false;
     }
+    out_data->bytes      = code.data;
+    out_data->bytes_size = code.size;
+#else
+    // The variant is already in the file path.
+    (void)variant_mask;
+    if (resources->pack.data != nullptr) {
+      auto name  = resource.file_path + SDL_strlen("res/");
+      auto entry = resource_pack_find(resources->pack.data, name);
+      if (entry == nullptr) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Resource pack has no entry %s", name);
+        return false;
+      }
 
-    SDL_ShaderCross_HLSL_Info hlsl_info = {};
-    hlsl_info.source                    = file_contents.c_str();
-    hlsl_info.entrypoint                = "main";
-    hlsl_info.shader_stage              = resource_info.shader.stage == SDL_GPU_SHADERSTAGE_VERTEX
-                                              ? SDL_SHADERCROSS_SHADERSTAGE_VERTEX
-                                              : SDL_SHADERCROSS_SHADERSTAGE_FRAGMENT;
-    size_t   data_size;
-    uint8_t* data = nullptr;
-    switch (resources->shader_format) {
-    case SDL_GPU_SHADERFORMAT_DXIL: {
-      data = static_cast<uint8_t*>(SDL_ShaderCross_CompileDXILFromHLSL(&hlsl_info, &data_size));
-      if (data == nullptr) {
-        SDL_LogError(
-            SDL_LOG_CATEGORY_APPLICATION,
-            "Failed to compile DXIL from hlsl:\n%s",
-            SDL_GetError());
+      if ((entry->flags & RESOURCE_PACK_FLAG_LZ4) == 0) {
+        out_data->bytes      = resources->pack.data + entry->offset;
+        out_data->bytes_size = entry->size;
+        return true;
+      }
+
+      auto bytes = static_cast<uint8_t*>(arena_push(arena, entry->uncompressed_size));
+      if (bytes == nullptr ||
+          !lz4_decompress(
+              resources->pack.data + entry->offset,
+              entry->size,
+              bytes,
+              entry->uncompressed_size)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to decompress resource %s", name);
         return false;
       }
-    } break;
-    case SDL_GPU_SHADERFORMAT_SPIRV: {
-      data = static_cast<uint8_t*>(SDL_ShaderCross_CompileSPIRVFromHLSL(&hlsl_info, &data_size));
-      if (data == nullptr) {
+      out_data->bytes      = bytes;
+      out_data->bytes_size = entry->uncompressed_size;
+    } else {
+      Byte_Span span;
+      if (!read_storage_file(storage, resource.file_path, arena, &span)) {
         SDL_LogError(
             SDL_LOG_CATEGORY_APPLICATION,
-            "Failed to compile SPIRV from hlsl:\n%s",
-            SDL_GetError());
+            "Failed to read file contents: %s",
+            resource.file_path);
         return false;
       }
-    } break;
-    default:
-      break;
+      out_data->bytes      = span.data;
+      out_data->bytes_size = span.size;
     }
-    SDL_assert(data != nullptr);
-    shader_code.assign(data, data + data_size);
-    SDL_free(data);
-#else
-    resource->file_path =
-        std::string("res/") + resource_info.file_name + "." + resources->shader_file_ext;
-
-    if (!read_storage_file(storage, resource->file_path.c_str(), &shader_code)) {
+#endif
+  } break;
+  case RESOURCE_KIND_TEXTURE: {
+    auto generator = texture_generator_find(resource_info.file_name);
+    if (generator == nullptr) {
       SDL_LogError(
           SDL_LOG_CATEGORY_APPLICATION,
-          "Failed to read file contents: %s",
-          resource->file_path.c_str());
+          "No generator for texture %s",
+          resource_info.file_name);
       return false;
     }
-#endif
 
-    SDL_GPUShaderCreateInfo info = {};
-    info.code                    = shader_code.data();
-    info.code_size               = shader_code.size();
-    info.entrypoint              = "main";
-    info.format                  = resources->shader_format;
-    info.num_samplers            = resource_info.shader.samplers_count;
-    info.num_storage_textures    = resource_info.shader.storage_textures_count;
-    info.num_storage_buffers     = resource_info.shader.storage_buffers_count;
-    info.num_uniform_buffers     = resource_info.shader.uniform_buffers_count;
-    info.stage                   = resource_info.shader.stage;
-    resource->shader.handle      = SDL_CreateGPUShader(device, &info);
-    if (resource->shader.handle == nullptr) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create shader: %s", SDL_GetError());
+    auto size   = generator->width * generator->height * generator->bytes_per_texel;
+    auto texels = static_cast<uint8_t*>(arena_push(arena, size));
+    if (texels == nullptr) { return false; }
+    auto start_counter = SDL_GetPerformanceCounter();
+    generator->generate(texels);
+    SDL_LogInfo(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Generated texture %s (%dx%d) in %.3f ms",
+        resource_info.file_name,
+        generator->width,
+        generator->height,
+        static_cast<double>(SDL_GetPerformanceCounter() - start_counter) * 1000.0 /
+            static_cast<double>(SDL_GetPerformanceFrequency()));
+    if (generator->report != nullptr) { generator->report(texels); }
+
+    out_data->bytes      = texels;
+    out_data->bytes_size = size;
+  } break;
+  default:
+    break;
+  }
+
+  return true;
+}
+
+static bool resource_create(
+    Resources*           resources,
+    Resource*            resource,
+    SDL_GPUDevice*       device,
+    const Resource_Info& resource_info,
+    const uint8_t*       data,
+    size_t               data_size) {
+  resource->kind = resource_info.kind;
+
+  switch (resource_info.kind) {
+  case RESOURCE_KIND_SHADER: {
+    if (!shader_create(resources, resource, device, resource_info, data, data_size)) {
+      return false;
+    }
+  } break;
+  case RESOURCE_KIND_COMPUTE_PIPELINE: {
+    if (!compute_pipeline_create(resources, resource, device, resource_info, data, data_size)) {
       return false;
     }
   } break;
+  case RESOURCE_KIND_TEXTURE: {
+    if (!texture_create(resource, device, resource_info, data, data_size)) { return false; }
+  } break;
   default:
     break;
   }
@@ -154,20 +844,198 @@ static bool resource_load(
   return true;
 }
 
+struct Resource_Load_Job {
+  Resources*    resources;
+  SDL_Storage*  storage;
+  Arena         arena;
+  Resource_ID   id;
+  Resource_Data data;
+  bool          succeeded;
+};
+
+static void resource_load_job(void* user_data) {
+  auto job       = static_cast<Resource_Load_Job*>(user_data);
+  job->succeeded = resource_read(
+      job->resources,
+      job->resources->items[job->id],
+      job->storage,
+      &job->arena,
+      job->id,
+      0,
+      &job->data);
+}
+
 static void resource_destroy(Resources* resources, Resource* resource, SDL_GPUDevice* device) {
   switch (resource->kind) {
   case RESOURCE_KIND_SHADER: {
     SDL_ReleaseGPUShader(device, resource->shader.handle);
   } break;
+  case RESOURCE_KIND_COMPUTE_PIPELINE: {
+    SDL_ReleaseGPUComputePipeline(device, resource->compute.handle);
+  } break;
+  case RESOURCE_KIND_TEXTURE: {
+    SDL_ReleaseGPUTexture(device, resource->texture.handle);
+  } break;
   default:
     break;
   }
 }
 
-static bool resources_load(Resources* resources, SDL_GPUDevice* device, SDL_Storage* storage) {
+// Like resource_destroy, but hands the GPU objects to the release queue so that frames still in
+// flight can keep using them.
+static void resource_retire(Resource* resource, GPU_Release_Queue* release_queue) {
+  switch (resource->kind) {
+  case RESOURCE_KIND_SHADER: {
+    gpu_release_queue_push(release_queue, GPU_OBJECT_KIND_SHADER, resource->shader.handle);
+  } break;
+  case RESOURCE_KIND_COMPUTE_PIPELINE: {
+    gpu_release_queue_push(
+        release_queue,
+        GPU_OBJECT_KIND_COMPUTE_PIPELINE,
+        resource->compute.handle);
+  } break;
+  case RESOURCE_KIND_TEXTURE: {
+    gpu_release_queue_push(release_queue, GPU_OBJECT_KIND_TEXTURE, resource->texture.handle);
+  } break;
+  default:
+    break;
+  }
+}
+
+static void shader_variant_job(void* user_data) {
+  auto variant       = static_cast<Shader_Variant*>(user_data);
+  variant->succeeded = resource_read(
+      variant->resources,
+      variant->resource,
+      variant->storage,
+      &variant->arena,
+      variant->id,
+      variant->mask,
+      &variant->data);
+  SDL_SetAtomicInt(&variant->state, SHADER_VARIANT_STATE_DONE);
+}
+
+// Returns the variant of a shader or compute pipeline resource once it has been created, and queues
+// loading it the first time it is asked for. Variant 0 is always there. Until the variant is there
+// the caller carries on with whichever one it used before, so switching never waits on a compile.
+static const Resource* resources_request_variant(
+    Resources*          resources,
+    Job_Pool*           job_pool,
+    SDL_Storage*        storage,
+    Resource_ID         id,
+    Shader_Variant_Mask mask) {
+  SDL_assert(resources != nullptr);
+  SDL_assert(job_pool != nullptr);
+  SDL_assert(storage != nullptr);
+  SDL_assert(mask < (1u << shader_permutation_axes_count(RESOURCES_PERMUTATION_AXES[id])));
+
+  if (mask == 0) { return &resources->items[id]; }
+
+  auto variant = &resources->variants[id][mask];
+  auto state   = SDL_GetAtomicInt(&variant->state);
+  if (state == SHADER_VARIANT_STATE_READY) { return &variant->resource; }
+  if (state != SHADER_VARIANT_STATE_EMPTY) { return nullptr; }
+
+  variant->resource  = {};
+  variant->outdated  = false;
+  variant->resources = resources;
+  variant->storage   = storage;
+  variant->id        = id;
+  variant->mask      = mask;
+  variant->data      = {};
+  variant->succeeded = false;
+#ifdef BUILD_DEBUG
+  SDL_strlcpy(
+      variant->resource.file_path,
+      resources->items[id].file_path,
+      sizeof(variant->resource.file_path));
+#else
+  char file_name[RESOURCE_MAX_PATH_SIZE];
+  shader_variant_file_name(RESOURCES_INFO[id].file_name, mask, file_name, sizeof(file_name));
+  SDL_snprintf(
+      variant->resource.file_path,
+      sizeof(variant->resource.file_path),
+      "res/%s.%s",
+      file_name,
+      resources->shader_file_ext);
+#endif
+  variant->start_ticks = SDL_GetTicks();
+  arena_reset(&variant->arena);
+  SDL_SetAtomicInt(&variant->state, SHADER_VARIANT_STATE_PENDING);
+
+  job_pool_push(job_pool, shader_variant_job, variant);
+
+  return nullptr;
+}
+
+static bool resources_variant_failed(
+    Resources*          resources,
+    Resource_ID         id,
+    Shader_Variant_Mask mask) {
+  SDL_assert(resources != nullptr);
+
+  if (mask == 0) { return false; }
+  return SDL_GetAtomicInt(&resources->variants[id][mask].state) == SHADER_VARIANT_STATE_FAILED;
+}
+
+// Creates the variants whose loads have finished since the last call, on the main thread.
+static void resources_update_variants(Resources* resources, SDL_GPUDevice* device) {
+  SDL_assert(resources != nullptr);
+  SDL_assert(device != nullptr);
+
+  for (int i = 0; i < RESOURCE_ID_COUNT; i++) {
+    auto variants_count = 1 << shader_permutation_axes_count(RESOURCES_PERMUTATION_AXES[i]);
+    for (int mask = 1; mask < variants_count; mask++) {
+      auto variant = &resources->variants[i][mask];
+      if (SDL_GetAtomicInt(&variant->state) != SHADER_VARIANT_STATE_DONE) { continue; }
+      if (variant->outdated) {
+        SDL_SetAtomicInt(&variant->state, SHADER_VARIANT_STATE_EMPTY);
+        continue;
+      }
+
+      auto        resource_info = RESOURCES_INFO[i];
+      const auto& data          = variant->data;
+#ifdef BUILD_DEBUG
+      resource_info.shader.bindings  = data.shader_reflection.bindings;
+      resource_info.compute.bindings = data.shader_reflection.compute_bindings;
+#endif
+      if (!variant->succeeded ||
+          !resource_create(
+              resources,
+              &variant->resource,
+              device,
+              resource_info,
+              data.bytes,
+              data.bytes_size)) {
+        SDL_LogError(
+            SDL_LOG_CATEGORY_APPLICATION,
+            "Failed to load variant %d of resource %s",
+            mask,
+            resource_info.file_name);
+        SDL_SetAtomicInt(&variant->state, SHADER_VARIANT_STATE_FAILED);
+        continue;
+      }
+      SDL_SetAtomicInt(&variant->state, SHADER_VARIANT_STATE_READY);
+
+      SDL_LogInfo(
+          SDL_LOG_CATEGORY_APPLICATION,
+          "Loaded variant %d of resource %s (%llu ms)",
+          mask,
+          resource_info.file_name,
+          static_cast<unsigned long long>(SDL_GetTicks() - variant->start_ticks));
+    }
+  }
+}
+
+static bool resources_load(
+    Resources*     resources,
+    SDL_GPUDevice* device,
+    SDL_Storage*   storage,
+    Job_Pool*      job_pool) {
   SDL_assert(resources != nullptr);
   SDL_assert(storage != nullptr);
   SDL_assert(device != nullptr);
+  SDL_assert(job_pool != nullptr);
 
   auto device_shader_formats = SDL_GetGPUShaderFormats(device);
   if ((device_shader_formats & SDL_GPU_SHADERFORMAT_DXIL) != 0) {
@@ -186,10 +1054,83 @@ static bool resources_load(Resources* resources, SDL_GPUDevice* device, SDL_Stor
     return false;
   }
 
+#ifdef BUILD_DEBUG
+  if (!shader_cache_init(&resources->shader_cache)) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to init shader cache");
+    return false;
+  }
+#endif
+
+  auto start_ticks = SDL_GetTicks();
+
+#ifndef BUILD_DEBUG
+  // The resource pack is mapped once and left mapped until resources_destroy. Loose files in res/
+  // are only read when there is no pack next to the executable.
+  {
+    auto base_path = SDL_GetBasePath();
+    auto pack_path = std::string(base_path != nullptr ? base_path : "") + RESOURCE_PACK_FILE_PATH;
+    if (map_file(pack_path.c_str(), &resources->pack)) {
+      if (!resource_pack_validate(resources->pack.data, resources->pack.size)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Invalid resource pack: %s", pack_path.c_str());
+        return false;
+      }
+    } else {
+      SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "No resource pack, loading loose files");
+    }
+  }
+#endif
+
   for (int i = 0; i < RESOURCE_ID_COUNT; i++) {
-    auto        resource      = &resources->items[i];
     const auto& resource_info = RESOURCES_INFO[i];
-    if (!resource_load(resources, resource, device, storage, resource_info)) {
+    // Generated textures have no file.
+    if (resource_info.kind == RESOURCE_KIND_TEXTURE) {
+      SDL_snprintf(
+          resources->items[i].file_path,
+          sizeof(resources->items[i].file_path),
+          "%s",
+          resource_info.file_name);
+      continue;
+    }
+#ifdef BUILD_DEBUG
+    SDL_snprintf(
+        resources->items[i].file_path,
+        sizeof(resources->items[i].file_path),
+        "src/%s.hlsl",
+        resource_info.file_name);
+#else
+    SDL_snprintf(
+        resources->items[i].file_path,
+        sizeof(resources->items[i].file_path),
+        "res/%s.%s",
+        resource_info.file_name,
+        resources->shader_file_ext);
+#endif
+  }
+
+  // Reading and compiling is fanned out across the job pool, but the GPU objects are created on
+  // this thread in resource id order so that loading stays deterministic.
+  std::array<Resource_Load_Job, RESOURCE_ID_COUNT> jobs = {};
+  defer(for (auto& job : jobs) { arena_destroy(&job.arena); });
+  for (int i = 0; i < RESOURCE_ID_COUNT; i++) {
+    auto job       = &jobs[i];
+    job->resources = resources;
+    job->storage   = storage;
+    job->id        = static_cast<Resource_ID>(i);
+    job->succeeded = false;
+    job_pool_push(job_pool, resource_load_job, job);
+  }
+  job_pool_wait(job_pool);
+
+  for (int i = 0; i < RESOURCE_ID_COUNT; i++) {
+    auto        resource      = &resources->items[i];
+    auto        resource_info = RESOURCES_INFO[i];
+    const auto& data          = jobs[i].data;
+#ifdef BUILD_DEBUG
+    resource_info.shader.bindings  = data.shader_reflection.bindings;
+    resource_info.compute.bindings = data.shader_reflection.compute_bindings;
+#endif
+    if (!jobs[i].succeeded ||
+        !resource_create(resources, resource, device, resource_info, data.bytes, data.bytes_size)) {
       SDL_LogError(
           SDL_LOG_CATEGORY_APPLICATION,
           "Failed to load resource: kind=%d, file_name:%s",
@@ -197,90 +1138,198 @@ static bool resources_load(Resources* resources, SDL_GPUDevice* device, SDL_Stor
           resource_info.file_name);
       return false;
     }
+#ifdef BUILD_DEBUG
+    resource->source_hash = data.shader_source.hash;
+    resources_set_shader_includes(
+        resources,
+        static_cast<Resource_ID>(i),
+        data.shader_source.includes);
+#endif
 
-    SDL_PathInfo path_info;
-    if (!SDL_GetStoragePathInfo(storage, resource->file_path.c_str(), &path_info)) {
-      SDL_LogError(
-          SDL_LOG_CATEGORY_APPLICATION,
-          "Failed to get resource file path info: %s",
-          SDL_GetError());
-      return false;
-    }
-    resource->last_modify_time = path_info.modify_time;
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Loaded resource %s", resource->file_path);
+  }
+
+  SDL_LogInfo(
+      SDL_LOG_CATEGORY_APPLICATION,
+      "Loaded %d resources in %llu ms using %d threads",
+      RESOURCE_ID_COUNT,
+      static_cast<unsigned long long>(SDL_GetTicks() - start_ticks),
+      static_cast<int>(job_pool->threads.size()));
+
+  return true;
+}
 
-    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Loaded resource %s", resource->file_path.c_str());
+#ifdef BUILD_DEBUG
+// Drops the variants of a reloaded resource, which are loaded again when next asked for.
+static void resources_reset_variants(
+    Resources*         resources,
+    Resource_ID        id,
+    GPU_Release_Queue* release_queue) {
+  for (auto& variant : resources->variants[id]) {
+    switch (SDL_GetAtomicInt(&variant.state)) {
+    case SHADER_VARIANT_STATE_PENDING:
+    case SHADER_VARIANT_STATE_DONE: {
+      variant.outdated = true;
+    } break;
+    case SHADER_VARIANT_STATE_READY: {
+      resource_retire(&variant.resource, release_queue);
+      SDL_SetAtomicInt(&variant.state, SHADER_VARIANT_STATE_EMPTY);
+    } break;
+    case SHADER_VARIANT_STATE_FAILED: {
+      SDL_SetAtomicInt(&variant.state, SHADER_VARIANT_STATE_EMPTY);
+    } break;
+    default:
+      break;
+    }
   }
+}
+
+static bool resources_watch(Resources* resources, const char* base_path) {
+  SDL_assert(resources != nullptr);
+  SDL_assert(base_path != nullptr);
 
-  SDL_GetCurrentTime(&resources->last_time);
+  if (!file_watcher_start(&resources->watcher, base_path)) { return false; }
+
+  for (int i = 0; i < RESOURCE_ID_COUNT; i++) {
+    if (RESOURCES_INFO[i].kind == RESOURCE_KIND_TEXTURE) { continue; }
+    if (!file_watcher_add(&resources->watcher, i, resources->items[i].file_path)) {
+      return false;
+    }
+  }
+  for (int i = 0; i < static_cast<int>(resources->shader_includes.size()); i++) {
+    const auto& include = resources->shader_includes[i];
+    if (!file_watcher_add(&resources->watcher, RESOURCE_ID_COUNT + i, include.file_path.c_str())) {
+      return false;
+    }
+  }
 
   return true;
 }
 
+// Kicks off background compiles for the resources the watcher reported as modified and swaps in
+// the shaders of compiles that have finished. Until a compile finishes the old shader stays in
+// place, so the caller only has to rebuild pipelines for the returned resource ids. The returned
+// ids are pushed onto the frame arena.
 static void resources_live_reload(
-    Resources*                                  resources,
-    SDL_GPUDevice*                              device,
-    SDL_Storage*                                storage,
-    std::array<Resource_ID, RESOURCE_ID_COUNT>* out_modified_resource_ids,
-    int*                                        out_modified_resource_ids_count) {
+    Resources*         resources,
+    SDL_GPUDevice*     device,
+    SDL_Storage*       storage,
+    Job_Pool*          job_pool,
+    GPU_Release_Queue* release_queue,
+    Arena*             frame_arena,
+    Resource_ID**      out_modified_resource_ids,
+    int*               out_modified_resource_ids_count) {
   SDL_assert(resources != nullptr);
   SDL_assert(device != nullptr);
   SDL_assert(storage != nullptr);
+  SDL_assert(job_pool != nullptr);
+  SDL_assert(release_queue != nullptr);
+  SDL_assert(frame_arena != nullptr);
   SDL_assert(out_modified_resource_ids != nullptr);
   SDL_assert(out_modified_resource_ids_count != nullptr);
 
+  *out_modified_resource_ids       = arena_push_array<Resource_ID>(frame_arena, RESOURCE_ID_COUNT);
   *out_modified_resource_ids_count = 0;
 
-  SDL_Time current_time;
-  SDL_GetCurrentTime(&current_time);
-  auto delta_time = current_time - resources->last_time;
-  if (SDL_NS_TO_SECONDS(static_cast<float>(delta_time)) < 0.5f) { return; }
+  // Drain the watcher queue first so that several events for the same file (e.g. an editor that
+  // truncates then writes) only cause a single compile.
+  auto modified = arena_push_array<bool>(frame_arena, RESOURCE_ID_COUNT);
+  int  id;
+  while (file_watcher_pop(&resources->watcher, &id)) {
+    if (id >= 0 && id < RESOURCE_ID_COUNT) {
+      modified[id] = true;
+    } else if (id >= RESOURCE_ID_COUNT) {
+      auto include_index = static_cast<size_t>(id - RESOURCE_ID_COUNT);
+      if (include_index >= resources->shader_includes.size()) { continue; }
+      const auto& include = resources->shader_includes[include_index];
+      for (int i = 0; i < RESOURCE_ID_COUNT; i++) { modified[i] |= include.dependents[i]; }
+    }
+  }
+  if (file_watcher_take_overflow(&resources->watcher)) {
+    for (int i = 0; i < RESOURCE_ID_COUNT; i++) { modified[i] = true; }
+  }
 
   for (int i = 0; i < RESOURCE_ID_COUNT; i++) {
-    const auto& resource_info = RESOURCES_INFO[i];
-
-    SDL_PathInfo path_info;
-    if (!SDL_GetStoragePathInfo(storage, resources->items[i].file_path.c_str(), &path_info)) {
-      SDL_LogError(
-          SDL_LOG_CATEGORY_APPLICATION,
-          "Failed to get resource file path info: %s",
-          SDL_GetError());
-      continue;
-    }
+    if (RESOURCES_INFO[i].kind == RESOURCE_KIND_TEXTURE) { continue; }
+    auto job   = &resources->compile_jobs[i];
+    auto state = SDL_GetAtomicInt(&job->state);
 
-    if (resources->items[i].last_modify_time == path_info.modify_time) { continue; }
-    resources->items[i].last_modify_time = path_info.modify_time;
+    if (state == SHADER_COMPILE_STATE_DONE) {
+      SDL_SetAtomicInt(&job->state, SHADER_COMPILE_STATE_IDLE);
+      state = SHADER_COMPILE_STATE_IDLE;
 
-    Resource resource = resources->items[i];
-    if (!resource_load(resources, &resource, device, storage, resource_info)) {
-      SDL_LogError(
-          SDL_LOG_CATEGORY_APPLICATION,
-          "Failed to live reload resource: kind=%d, file_name:%s",
-          resource_info.kind,
-          resource_info.file_name);
-      continue;
-    }
+      auto     resource_info         = RESOURCES_INFO[i];
+      Resource resource              = resources->items[i];
+      resource_info.shader.bindings  = job->reflection.bindings;
+      resource_info.compute.bindings = job->reflection.compute_bindings;
+      if (job->preprocessed) {
+        resources_set_shader_includes(resources, static_cast<Resource_ID>(i), job->source.includes);
+      }
+      if (job->unchanged) {
+        SDL_LogInfo(
+            SDL_LOG_CATEGORY_APPLICATION,
+            "Skipped live reload of %s: preprocessed source unchanged",
+            resources->items[i].file_path);
+      } else if (
+          !job->succeeded ||
+          !resource_create(
+              resources,
+              &resource,
+              device,
+              resource_info,
+              job->code.data,
+              job->code.size)) {
+        SDL_LogError(
+            SDL_LOG_CATEGORY_APPLICATION,
+            "Failed to live reload resource: kind=%d, file_name:%s",
+            resource_info.kind,
+            resource_info.file_name);
+      } else {
+        resource_retire(&resources->items[i], release_queue);
+        resource.source_hash = job->source.hash;
+        resources->items[i]  = resource;
+        resources_reset_variants(resources, static_cast<Resource_ID>(i), release_queue);
 
-    resource_destroy(resources, &resources->items[i], device);
-    resources->items[i] = resource;
+        (*out_modified_resource_ids)[*out_modified_resource_ids_count] =
+            static_cast<Resource_ID>(i);
+        *out_modified_resource_ids_count += 1;
 
-    (*out_modified_resource_ids)[*out_modified_resource_ids_count] = static_cast<Resource_ID>(i);
-    *out_modified_resource_ids_count += 1;
+        SDL_LogInfo(
+            SDL_LOG_CATEGORY_APPLICATION,
+            "Live reloaded resource %s (%llu ms)",
+            resources->items[i].file_path,
+            static_cast<unsigned long long>(SDL_GetTicks() - job->start_ticks));
+      }
+    }
 
-    SDL_LogInfo(
-        SDL_LOG_CATEGORY_APPLICATION,
-        "Live reloaded resource %s",
-        resources->items[i].file_path.c_str());
+    if (modified[i]) { job->pending = true; }
+    if (job->pending && state == SHADER_COMPILE_STATE_IDLE) {
+      shader_compile_job_submit(resources, job_pool, storage, static_cast<Resource_ID>(i));
+    }
   }
-
-  resources->last_time = current_time;
 }
+#endif
 
 static void resources_destroy(Resources* resources, SDL_GPUDevice* device) {
   SDL_assert(resources != nullptr);
   SDL_assert(device != nullptr);
 
+#ifdef BUILD_DEBUG
+  file_watcher_stop(&resources->watcher);
+  shader_cache_destroy(&resources->shader_cache);
+  for (auto& job : resources->compile_jobs) { arena_destroy(&job.scratch); }
+#else
+  unmap_file(&resources->pack);
+#endif
+
   for (int i = 0; i < RESOURCE_ID_COUNT; i++) {
     resource_destroy(resources, &resources->items[i], device);
+    for (auto& variant : resources->variants[i]) {
+      if (SDL_GetAtomicInt(&variant.state) == SHADER_VARIANT_STATE_READY) {
+        resource_destroy(resources, &variant.resource, device);
+      }
+      arena_destroy(&variant.arena);
+    }
   }
 }
 
@@ -290,6 +1339,12 @@ static const Resource& resources_get(const Resources& resources, Resource_ID id)
   case RESOURCE_KIND_SHADER:
     SDL_assert(resource.shader.handle != nullptr);
     break;
+  case RESOURCE_KIND_COMPUTE_PIPELINE:
+    SDL_assert(resource.compute.handle != nullptr);
+    break;
+  case RESOURCE_KIND_TEXTURE:
+    SDL_assert(resource.texture.handle != nullptr);
+    break;
   default:
     break;
   }
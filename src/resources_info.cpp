@@ -0,0 +1,58 @@
+// Generated by gen_resources.cpp, do not edit.
+
+enum Resource_ID {
+  RESOURCE_ID_SHADER_VERTEX_FULLSCREEN,
+  RESOURCE_ID_SHADER_FRAGMENT_PLACEHOLDER,
+  RESOURCE_ID_SHADER_FRAGMENT_FBM_WARP,
+  RESOURCE_ID_SHADER_FRAGMENT_FBM_WARP_TEXTURE,
+  RESOURCE_ID_SHADER_FRAGMENT_FBM_WARP_CACHED,
+  RESOURCE_ID_SHADER_FRAGMENT_PLASMA_BEAT,
+  RESOURCE_ID_SHADER_FRAGMENT_UPSCALE_EASU,
+  RESOURCE_ID_SHADER_FRAGMENT_SHARPEN_RCAS,
+  RESOURCE_ID_SHADER_FRAGMENT_CHECKERBOARD_RESOLVE,
+  RESOURCE_ID_SHADER_FRAGMENT_CHECKERBOARD_ERROR,
+  RESOURCE_ID_SHADER_FRAGMENT_FBM_WARP_FIELD,
+  RESOURCE_ID_SHADER_COMPUTE_FBM_WARP_COMPUTE,
+  RESOURCE_ID_SHADER_COMPUTE_PLASMA_BEAT_COMPUTE,
+  RESOURCE_ID_TEXTURE_NOISE_LATTICE,
+  RESOURCE_ID_COUNT,
+};
+
+// Shader bindings are samplers, storage textures, storage buffers, uniform buffers.
+// Compute bindings are samplers, read only storage textures and buffers, read write
+// storage textures and buffers, uniform buffers, then the thread counts.
+static constexpr std::array<Resource_Info, RESOURCE_ID_COUNT> RESOURCES_INFO = {{
+    {RESOURCE_KIND_SHADER, "fullscreen", {SDL_GPU_SHADERSTAGE_VERTEX, {0, 0, 0, 0}}, {}},
+    {RESOURCE_KIND_SHADER, "placeholder", {SDL_GPU_SHADERSTAGE_FRAGMENT, {0, 0, 0, 0}}, {}},
+    {RESOURCE_KIND_SHADER, "fbm_warp", {SDL_GPU_SHADERSTAGE_FRAGMENT, {0, 0, 0, 1}}, {}},
+    {RESOURCE_KIND_SHADER, "fbm_warp_texture", {SDL_GPU_SHADERSTAGE_FRAGMENT, {1, 0, 0, 1}}, {}},
+    {RESOURCE_KIND_SHADER, "fbm_warp_cached", {SDL_GPU_SHADERSTAGE_FRAGMENT, {2, 0, 0, 2}}, {}},
+    {RESOURCE_KIND_SHADER, "plasma_beat", {SDL_GPU_SHADERSTAGE_FRAGMENT, {0, 0, 0, 2}}, {}},
+    {RESOURCE_KIND_SHADER, "upscale_easu", {SDL_GPU_SHADERSTAGE_FRAGMENT, {1, 0, 0, 1}}, {}},
+    {RESOURCE_KIND_SHADER, "sharpen_rcas", {SDL_GPU_SHADERSTAGE_FRAGMENT, {1, 0, 0, 1}}, {}},
+    {RESOURCE_KIND_SHADER, "checkerboard_resolve", {SDL_GPU_SHADERSTAGE_FRAGMENT, {2, 0, 0, 1}}, {}},
+    {RESOURCE_KIND_SHADER, "checkerboard_error", {SDL_GPU_SHADERSTAGE_FRAGMENT, {2, 0, 0, 1}}, {}},
+    {RESOURCE_KIND_SHADER, "fbm_warp_field", {SDL_GPU_SHADERSTAGE_FRAGMENT, {0, 0, 0, 2}}, {}},
+    {RESOURCE_KIND_COMPUTE_PIPELINE, "fbm_warp_compute", {}, {{0, 0, 0, 1, 0, 1, 8, 8, 1}}},
+    {RESOURCE_KIND_COMPUTE_PIPELINE, "plasma_beat_compute", {}, {{0, 0, 0, 1, 0, 2, 8, 8, 1}}},
+    {RESOURCE_KIND_TEXTURE, "noise_lattice", {}, {}},
+}};
+
+// The permutation axes of every resource, followed by its file name.
+static constexpr std::array<Shader_Permutation_Axes, RESOURCE_ID_COUNT>
+    RESOURCES_PERMUTATION_AXES = {{
+    {},                     // fullscreen
+    {},                     // placeholder
+    {{"FBM_LOW_OCTAVES"}},  // fbm_warp
+    {{"FBM_LOW_OCTAVES"}},  // fbm_warp_texture
+    {{"FBM_LOW_OCTAVES"}},  // fbm_warp_cached
+    {},                     // plasma_beat
+    {},                     // upscale_easu
+    {},                     // sharpen_rcas
+    {},                     // checkerboard_resolve
+    {},                     // checkerboard_error
+    {},                     // fbm_warp_field
+    {{"FBM_LOW_OCTAVES"}},  // fbm_warp_compute
+    {},                     // plasma_beat_compute
+    {},                     // noise_lattice
+}};
@@ -11,31 +11,330 @@
 #include <SDL3_shadercross/SDL_shadercross.h>
 #endif
 
+// -- Platform Header Includes ------------------------------------------------
+#ifdef SDL_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#endif
+
+#if defined(BUILD_DEBUG) && defined(SDL_PLATFORM_LINUX)
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
 // -- Std Header Includes -----------------------------------------------------
+#include <algorithm>
 #include <array>
+#include <cstdlib>
+#include <deque>
+#include <new>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // -- Local Source Includes ---------------------------------------------------
+#include "alloc_tracker.cpp"
+#include "bench.cpp"
 #include "common.cpp"
+#include "dynamic_resolution.cpp"
+#ifdef BUILD_DEBUG
+#include "file_watcher.cpp"
+#include "shader_cache.cpp"
+#endif
+#include "gpu_release_queue.cpp"
 #include "imgui_font.cpp"
+#include "jobs.cpp"
+#include "noise_texture.cpp"
+#include "resource_pack.cpp"
 #include "resources.cpp"
+#include "shader_prepare.cpp"
+#include "warp_field_cache.cpp"
+
+// The fragment shaders of the fixed passes of the renderer, indexed by Pass_Pipeline.
+enum Pass_Pipeline {
+  PASS_PIPELINE_PLACEHOLDER,
+  PASS_PIPELINE_UPSCALE_EASU,
+  PASS_PIPELINE_SHARPEN_RCAS,
+  PASS_PIPELINE_CHECKERBOARD_RESOLVE,
+  PASS_PIPELINE_CHECKERBOARD_ERROR,
+  PASS_PIPELINE_FBM_WARP_FIELD,
+  PASS_PIPELINE_COUNT,
+};
+
+static constexpr std::array<Resource_ID, PASS_PIPELINE_COUNT> PASS_RESOURCE_IDS = {
+    RESOURCE_ID_SHADER_FRAGMENT_PLACEHOLDER,
+    RESOURCE_ID_SHADER_FRAGMENT_UPSCALE_EASU,
+    RESOURCE_ID_SHADER_FRAGMENT_SHARPEN_RCAS,
+    RESOURCE_ID_SHADER_FRAGMENT_CHECKERBOARD_RESOLVE,
+    RESOURCE_ID_SHADER_FRAGMENT_CHECKERBOARD_ERROR,
+    RESOURCE_ID_SHADER_FRAGMENT_FBM_WARP_FIELD,
+};
+
+// Every other fragment shader in RESOURCES_INFO is a selectable shader kind, drawn with the
+// fullscreen vertex shader. A shader kind is an index into SHADER_KIND_RESOURCE_IDS.
+typedef int Shader_Kind;
+
+static constexpr bool is_shader_kind_resource(int id) {
+  const auto& info = RESOURCES_INFO[id];
+  if (info.kind != RESOURCE_KIND_SHADER || info.shader.stage != SDL_GPU_SHADERSTAGE_FRAGMENT) {
+    return false;
+  }
+  for (auto pass_id : PASS_RESOURCE_IDS) {
+    if (id == pass_id) { return false; }
+  }
+  return true;
+}
+
+static constexpr int SHADER_KIND_COUNT = []() {
+  int count = 0;
+  for (int i = 0; i < RESOURCE_ID_COUNT; i++) {
+    if (is_shader_kind_resource(i)) { count += 1; }
+  }
+  return count;
+}();
+
+static constexpr auto SHADER_KIND_RESOURCE_IDS = []() {
+  std::array<Resource_ID, SHADER_KIND_COUNT> result = {};
+  int                                        count  = 0;
+  for (int i = 0; i < RESOURCE_ID_COUNT; i++) {
+    if (is_shader_kind_resource(i)) {
+      result[count] = static_cast<Resource_ID>(i);
+      count += 1;
+    }
+  }
+  return result;
+}();
+
+// A shader kind can also have a compute version, a compute pipeline resource named after the
+// fragment shader with a "_compute" suffix, that draws the same image.
+static constexpr bool is_compute_variant_name(std::string_view name, std::string_view kind_name) {
+  return name.size() > kind_name.size() && name.substr(0, kind_name.size()) == kind_name &&
+         name.substr(kind_name.size()) == "_compute";
+}
+
+// RESOURCE_ID_COUNT for the shader kinds without a compute version.
+static constexpr auto SHADER_KIND_COMPUTE_RESOURCE_IDS = []() {
+  std::array<Resource_ID, SHADER_KIND_COUNT> result = {};
+  for (int i = 0; i < SHADER_KIND_COUNT; i++) {
+    const char* kind_name = RESOURCES_INFO[SHADER_KIND_RESOURCE_IDS[i]].file_name;
+    result[i]             = RESOURCE_ID_COUNT;
+    for (int j = 0; j < RESOURCE_ID_COUNT; j++) {
+      const auto& info = RESOURCES_INFO[j];
+      if (info.kind == RESOURCE_KIND_COMPUTE_PIPELINE &&
+          is_compute_variant_name(info.file_name, kind_name)) {
+        result[i] = static_cast<Resource_ID>(j);
+      }
+    }
+  }
+  return result;
+}();
 
-enum Shader_Kind {
-  SHADER_KIND_FBM_WARP,
-  SHADER_KIND_PLASMA_BEAT,
-  SHADER_KIND_COUNT,
+// The compute version of a shader kind declares the same permutation axes as it, so that the
+// variant mask picked for the shader kind picks the same variant of both.
+static constexpr bool shader_kind_compute_axes_match() {
+  for (int i = 0; i < SHADER_KIND_COUNT; i++) {
+    auto compute_id = SHADER_KIND_COMPUTE_RESOURCE_IDS[i];
+    if (compute_id == RESOURCE_ID_COUNT) { continue; }
+
+    const auto& axes         = RESOURCES_PERMUTATION_AXES[SHADER_KIND_RESOURCE_IDS[i]];
+    const auto& compute_axes = RESOURCES_PERMUTATION_AXES[compute_id];
+    for (int j = 0; j < SHADER_PERMUTATION_MAX_AXES; j++) {
+      if ((axes[j] == nullptr) != (compute_axes[j] == nullptr)) { return false; }
+      if (axes[j] != nullptr && std::string_view(axes[j]) != compute_axes[j]) { return false; }
+    }
+  }
+  return true;
+}
+static_assert(shader_kind_compute_axes_match(), "A compute version has other axes than its kind");
+
+// Null for the shader kinds without a frame prepare hook.
+static constexpr auto SHADER_KIND_PREPARE_FUNCS = []() {
+  std::array<Shader_Prepare_Func, SHADER_KIND_COUNT> result = {};
+  for (int i = 0; i < SHADER_KIND_COUNT; i++) {
+    std::string_view kind_name = RESOURCES_INFO[SHADER_KIND_RESOURCE_IDS[i]].file_name;
+    for (const auto& hook : SHADER_PREPARE_HOOKS) {
+      if (kind_name == hook.name) { result[i] = hook.prepare; }
+    }
+  }
+  return result;
+}();
+
+// The shaders a pipeline is created from. The pipeline of each shader kind comes first, followed by
+// the pass pipelines.
+struct Pipeline_Shaders {
+  Resource_ID vertex_id;
+  Resource_ID fragment_id;
+};
+
+static constexpr int PIPELINE_COUNT = SHADER_KIND_COUNT + PASS_PIPELINE_COUNT;
+
+static constexpr auto PIPELINE_SHADERS = []() {
+  std::array<Pipeline_Shaders, PIPELINE_COUNT> result = {};
+  for (int i = 0; i < SHADER_KIND_COUNT; i++) {
+    result[i] = {RESOURCE_ID_SHADER_VERTEX_FULLSCREEN, SHADER_KIND_RESOURCE_IDS[i]};
+  }
+  for (int i = 0; i < PASS_PIPELINE_COUNT; i++) {
+    result[SHADER_KIND_COUNT + i] = {RESOURCE_ID_SHADER_VERTEX_FULLSCREEN, PASS_RESOURCE_IDS[i]};
+  }
+  return result;
+}();
+
+// For every resource, the pipelines created from it. Lets a live reload rebuild exactly the
+// pipelines that use the changed shaders.
+static constexpr auto RESOURCE_PIPELINE_DEPENDENTS = []() {
+  std::array<std::array<bool, PIPELINE_COUNT>, RESOURCE_ID_COUNT> result = {};
+  for (int i = 0; i < PIPELINE_COUNT; i++) {
+    result[PIPELINE_SHADERS[i].vertex_id][i]   = true;
+    result[PIPELINE_SHADERS[i].fragment_id][i] = true;
+  }
+  return result;
+}();
+
+enum Pipeline_State {
+  PIPELINE_STATE_IDLE,
+  PIPELINE_STATE_PENDING,  // Being created on the job pool.
+  PIPELINE_STATE_DONE,     // Created (or failed), waiting for the main thread to pick it up.
+};
+
+// Pipelines are created lazily on the job pool the first time their shader kind is selected (or
+// prefetched), while the placeholder pipeline is bound in their place. The inputs are written by
+// the main thread before the job is queued and the output is only read once the state is DONE.
+// A pipeline is built from one variant of the fragment shader. When another variant is picked, the
+// pipeline stays bound until the variant has been loaded and a pipeline built from it.
+struct Pipeline_Slot {
+  SDL_GPUGraphicsPipeline* pipeline;      // Only touched by the main thread.
+  Shader_Variant_Mask      variant_mask;  // Of the pipeline.
+  bool                     outdated;      // One of its shaders was reloaded, rebuild on next use.
+
+  // Per variant, not retried until one of its shaders is reloaded.
+  std::array<bool, SHADER_VARIANTS_MAX> failed;
+
+  SDL_AtomicInt            state;
+  SDL_GPUDevice*           device;
+  SDL_GPUTextureFormat     format;
+  SDL_GPUShader*           vertex_shader;
+  SDL_GPUShader*           fragment_shader;
+  Shader_Variant_Mask      created_variant_mask;
+  SDL_GPUGraphicsPipeline* created;
+  Uint64                   start_ticks;
 };
 
-struct Shader_FBM_Warp_Uniforms {
+// Matches the Uniform_Block in common.hlsl.
+struct Shader_Uniforms {
   float    time;
   HMM_Vec2 resolution;
+  float    checkerboard;
+};
+
+// Matches the Upscale_Uniforms in upscale_common.hlsl.
+struct Upscale_Uniforms {
+  HMM_Vec2 source_size;
+  HMM_Vec2 texture_size;
+  HMM_Vec2 output_size;
+  float    sharpness;
+  float    padding;
+};
+
+// Checkerboard rendering shades half of the pixels each frame, alternating between the two halves,
+// and reconstructs the other half from the previous frame. Picked per shader kind.
+enum Checkerboard_Mode {
+  CHECKERBOARD_MODE_OFF,
+  CHECKERBOARD_MODE_ON,
+  CHECKERBOARD_MODE_ERROR,  // Also shades every pixel, and shows where the two differ.
+  CHECKERBOARD_MODE_COUNT,
+};
+
+// Matches the Checkerboard_Uniforms in checkerboard_common.hlsl.
+struct Checkerboard_Uniforms {
+  HMM_Vec2 texture_size;
+  HMM_Vec2 render_size;
+  float    parity;
+  float    history_valid;
+  float    padding[2];
+};
+
+// fbm_warp_cached samples the first level of its warp, and optionally the second, from a field
+// rendered at a fraction of the render size by a prepass.
+struct Warp_Field_Mode {
+  const char* name;
+  const char* label;
+  float       scale;    // Of the field, relative to the render size.
+  bool        cache_r;  // Else only q is cached, and r evaluated per pixel.
+};
+
+static constexpr std::array<Warp_Field_Mode, 4> WARP_FIELD_MODES = {{
+    {"half_q", "Half, q", 0.5f, false},
+    {"half_qr", "Half, q and r", 0.5f, true},
+    {"quarter_q", "Quarter, q", 0.25f, false},
+    {"quarter_qr", "Quarter, q and r", 0.25f, true},
+}};
+
+// The largest field scale, which the warp field texture is created at.
+static constexpr float                WARP_FIELD_MAX_SCALE      = 0.5f;
+static constexpr SDL_GPUTextureFormat WARP_FIELD_TEXTURE_FORMAT =
+    SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
+
+// Matches the Warp_Field_Uniforms in fbm_warp_field_common.hlsl.
+struct Warp_Field_Uniforms {
+  HMM_Vec2 field_size;
+  HMM_Vec2 field_texture_size;
+  float    cache_r;
+  float    show_error;
+  float    field_blend;
+  float    padding;
+};
+
+// How the render target is scaled to the window.
+enum Upscaler {
+  UPSCALER_BILINEAR,
+  UPSCALER_EASU_RCAS,  // Edge adaptive upscale, then sharpen.
+  UPSCALER_COUNT,
+};
+
+// Number of frames checked for allocations by --alloc-check, after the warm up frames.
+static constexpr uint64_t ALLOC_CHECK_FRAMES_COUNT = 600;
+
+// Headless mode renders into render_target only, so any color target format will do.
+static constexpr SDL_GPUTextureFormat HEADLESS_TEXTURE_FORMAT =
+    SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+
+struct App_Args {
+  int         load_threads_count;
+  int         alloc_check_warmup_frames;  // -1 when not checking.
+  bool        headless;
+  int         headless_width;
+  int         headless_height;
+  int         frames_limit;       // 0 for no limit.
+  const char* shader_name;        // Of the initially selected shader kind, may be null.
+  const char* bench_output_path;  // Null when not benchmarking.
+  bool        compute_path;
+  const char* warp_field_mode_name;  // May be null.
+  bool        warp_field_temporal;
+  int         ring_hearts_count;
+  bool        cull_ring_hearts;
+
+  // Permutation axes to define for every shader kind that has them.
+  std::array<const char*, SHADER_PERMUTATION_MAX_AXES> shader_defines;
+  int                                                  shader_defines_count;
 };
 
 struct App_State {
   SDL_Storage*         title_storage;
   SDL_GPUDevice*       device;
-  SDL_Window*          window;
+  SDL_Window*          window;  // Null in headless mode.
+  bool                 headless;
   SDL_GPUTextureFormat swapchain_texture_format;
   float                content_scale;
   HMM_Vec2             window_size_pixels;
@@ -43,25 +342,81 @@ struct App_State {
   uint64_t             count_per_second;
   uint64_t             last_counter;
   uint64_t             max_counter_delta;
+  uint64_t             present_wait_counter;  // Of the last frame, see acquire_swapchain_texture.
   double               elapsed_time;
   bool                 vsync      = true;
   bool                 fullscreen = false;
 
   ImFont* imgui_font;
 
-  Shader_Kind                                             shader_kind = SHADER_KIND_FBM_WARP;
-  Resources                                               resources;
-  std::array<SDL_GPUGraphicsPipeline*, SHADER_KIND_COUNT> pipelines;
-  SDL_GPUTexture*                                         render_target;
-  int                                                     render_scale_index;
-  HMM_Vec2                                                render_size;
-};
-
-static constexpr std::array<Resource_ID, SHADER_KIND_COUNT> SHADER_KIND_RESOURCE_IDS = {
-    {
-        RESOURCE_ID_SHADER_FRAGMENT_FBM_WARP,
-        RESOURCE_ID_SHADER_FRAGMENT_PLASMA_BEAT,
-    },
+  Job_Pool          job_pool;
+  GPU_Release_Queue release_queue;
+  Arena             frame_arena;  // Reset at the end of every frame.
+
+  Shader_Kind                                  shader_kind = 0;
+  Resources                                    resources;
+  std::array<Pipeline_Slot, SHADER_KIND_COUNT> pipelines;
+  SDL_GPUTexture*                              render_target;  // At the window size.
+  int                                          render_scale_index;
+  Dynamic_Resolution                           dynamic_resolution;
+  HMM_Vec2                                     render_size;  // Of the viewport in render_target.
+  uint64_t                                     frames_count;
+  int                                          pipeline_builds_count;  // Since the window start.
+  int                                          pipeline_builds_per_second;
+  Uint64                                       pipeline_builds_window_start_ticks;
+
+  std::array<SDL_GPUGraphicsPipeline*, PASS_PIPELINE_COUNT> pass_pipelines;
+  SDL_GPUTexture*                                           upscale_target;  // At the window size.
+  SDL_GPUSampler*                                           point_sampler;
+  SDL_GPUSampler*                                           repeat_sampler;
+  SDL_GPUSampler*                                           linear_sampler;
+  Upscaler                                                  upscaler  = UPSCALER_EASU_RCAS;
+  float                                                     sharpness = 0.2f;  // In stops.
+
+  // The textures are created on first use, at the window size. The field only needs half of the
+  // width, but sharing the size keeps resizing in one place. The history was written with the
+  // frames_count one less than checkerboard_history_frame, for the kind and size stored with it.
+  std::array<Checkerboard_Mode, SHADER_KIND_COUNT> checkerboard_modes;
+  SDL_GPUTexture*                                  checkerboard_field;
+  std::array<SDL_GPUTexture*, 2>                   checkerboard_history;  // Indexed by parity.
+  uint64_t                                         checkerboard_history_frame;
+  Shader_Kind                                      checkerboard_history_kind;
+  HMM_Vec2                                         checkerboard_history_size;
+
+  // Draws the shader kinds that have a compute version with it, into the compute target rather than
+  // the render target. Storage textures can't have the swapchain format (BGRA on most platforms),
+  // so the target has its own, and is created on first use at the window size.
+  bool            compute_path;
+  SDL_GPUTexture* compute_target;
+
+  // The variant picked for each shader kind, and the variant of its compute version in use, which
+  // follows once the picked one has been loaded.
+  std::array<Shader_Variant_Mask, SHADER_KIND_COUNT> shader_kind_variant_masks;
+  std::array<Shader_Variant_Mask, SHADER_KIND_COUNT> compute_variant_masks;
+
+  // The fields fbm_warp_cached samples its warp from. The textures are created on first use, at
+  // WARP_FIELD_MAX_SCALE of the window size, and the fields drawn into their top left corner.
+  int              warp_field_mode_index;  // Into WARP_FIELD_MODES.
+  bool             warp_field_show_error;
+  Warp_Field_Cache warp_field_cache;
+  Warp_Field_Frame warp_field_frame;  // Of the frame being recorded.
+
+  // Filled once per frame by the frame prepare hook of the selected shader kind, empty without one,
+  // followed by the quality settings the hooks go on.
+  alignas(16) std::array<uint8_t, SHADER_PREPARE_MAX_UNIFORMS_SIZE> shader_kind_uniforms;
+  uint32_t                                                          shader_kind_uniforms_size;
+  int                                                               ring_hearts_count;
+  bool                                                              cull_ring_hearts;
+
+  int         alloc_check_warmup_frames;
+  Alloc_Stats alloc_stats;  // Of the previous frame.
+
+  uint64_t           frames_limit;
+  std::vector<float> frame_times_ms;  // Recorded in headless mode, reserved up front.
+  Uint64             first_frame_counter;
+
+  bool  benchmarking;
+  Bench bench;
 };
 
 static constexpr std::array RENDER_TARGET_SCALE_VALUES = {
@@ -72,56 +427,393 @@ static constexpr std::array RENDER_TARGET_SCALE_VALUES = {
     0.5f,
 };
 
-static bool init_render_texture(App_State* as) {
-  as->render_size = as->window_size_pixels * RENDER_TARGET_SCALE_VALUES[as->render_scale_index];
+static bool parse_args(App_Args* args, int argc, char* argv[]) {
+  args->load_threads_count        = SDL_max(SDL_GetNumLogicalCPUCores(), 1);
+  args->alloc_check_warmup_frames = -1;
+  args->headless                  = false;
+  args->frames_limit              = 0;
+  args->shader_name               = nullptr;
+  args->bench_output_path         = nullptr;
+  args->compute_path              = false;
+  args->warp_field_mode_name      = nullptr;
+  args->warp_field_temporal       = false;
+  args->ring_hearts_count         = PLASMA_BEAT_RING_HEARTS_DEFAULT_COUNT;
+  args->cull_ring_hearts          = true;
+  args->shader_defines_count      = 0;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg      = argv[i];
+    const char* next_arg = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (SDL_strcmp(arg, "--load-threads") == 0 && next_arg != nullptr) {
+      args->load_threads_count = SDL_max(SDL_atoi(next_arg), 1);
+      i += 1;
+    } else if (SDL_strcmp(arg, "--alloc-check") == 0 && next_arg != nullptr) {
+#ifndef BUILD_ALLOC_TRACKER
+      SDL_LogError(
+          SDL_LOG_CATEGORY_APPLICATION,
+          "--alloc-check needs a build with the allocation tracker (alloc_tracker)");
+      return false;
+#endif
+      args->alloc_check_warmup_frames = SDL_max(SDL_atoi(next_arg), 0);
+      i += 1;
+    } else if (SDL_strcmp(arg, "--headless") == 0 && next_arg != nullptr) {
+      if (SDL_sscanf(next_arg, "%dx%d", &args->headless_width, &args->headless_height) != 2 ||
+          args->headless_width <= 0 || args->headless_height <= 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Invalid headless size: %s", next_arg);
+        return false;
+      }
+      args->headless = true;
+      i += 1;
+    } else if (SDL_strcmp(arg, "--frames") == 0 && next_arg != nullptr) {
+      args->frames_limit = SDL_max(SDL_atoi(next_arg), 1);
+      i += 1;
+    } else if (SDL_strcmp(arg, "--shader") == 0 && next_arg != nullptr) {
+      args->shader_name = next_arg;
+      i += 1;
+    } else if (SDL_strcmp(arg, "--bench") == 0 && next_arg != nullptr) {
+      args->bench_output_path = next_arg;
+      i += 1;
+    } else if (SDL_strcmp(arg, "--compute") == 0) {
+      args->compute_path = true;
+    } else if (SDL_strcmp(arg, "--warp-field") == 0 && next_arg != nullptr) {
+      args->warp_field_mode_name = next_arg;
+      i += 1;
+    } else if (SDL_strcmp(arg, "--warp-field-temporal") == 0) {
+      args->warp_field_temporal = true;
+    } else if (SDL_strcmp(arg, "--ring-hearts") == 0 && next_arg != nullptr) {
+      args->ring_hearts_count = SDL_clamp(SDL_atoi(next_arg), 1, PLASMA_BEAT_RING_HEARTS_MAX_COUNT);
+      i += 1;
+    } else if (SDL_strcmp(arg, "--no-heart-culling") == 0) {
+      args->cull_ring_hearts = false;
+    } else if (
+        SDL_strcmp(arg, "--shader-define") == 0 && next_arg != nullptr &&
+        args->shader_defines_count < SHADER_PERMUTATION_MAX_AXES) {
+      args->shader_defines[args->shader_defines_count] = next_arg;
+      args->shader_defines_count += 1;
+      i += 1;
+    } else {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unknown or incomplete argument: %s", arg);
+      SDL_Log(
+          "Usage: %s [--load-threads N] [--alloc-check N] [--headless WxH] [--frames N] "
+          "[--shader NAME] [--bench OUTPUT.json|OUTPUT.csv] [--compute] [--warp-field MODE] "
+          "[--warp-field-temporal] [--ring-hearts N] [--no-heart-culling] [--shader-define NAME]",
+          argv[0]);
+      return false;
+    }
+  }
 
-  SDL_GPUTexture* render_target;
-  {
-    SDL_GPUTextureCreateInfo info = {};
-    info.type                     = SDL_GPU_TEXTURETYPE_2D;
-    info.width                    = static_cast<int>(as->render_size.X);
-    info.height                   = static_cast<int>(as->render_size.Y);
-    info.layer_count_or_depth     = 1;
-    info.num_levels               = 1;
-    info.format                   = as->swapchain_texture_format;
-    info.usage    = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
-    render_target = SDL_CreateGPUTexture(as->device, &info);
-    if (render_target == nullptr) {
-      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create texture: %s", SDL_GetError());
+  return true;
+}
+
+// The render target is only recreated when the window size changes. Scaled rendering goes to a
+// viewport in its top left corner, so changing the render scale doesn't allocate.
+static void update_render_size(App_State* as) {
+  auto scale = as->dynamic_resolution.enabled ? as->dynamic_resolution.scale
+                                              : RENDER_TARGET_SCALE_VALUES[as->render_scale_index];
+  as->render_size = HMM_V2(
+      SDL_max(SDL_floorf(as->window_size_pixels.X * scale), 1.0f),
+      SDL_max(SDL_floorf(as->window_size_pixels.Y * scale), 1.0f));
+}
+
+// Replaces the texture with a new one.
+static bool init_texture(
+    App_State*               as,
+    SDL_GPUTexture**         texture,
+    HMM_Vec2                 size,
+    SDL_GPUTextureFormat     format,
+    SDL_GPUTextureUsageFlags usage) {
+  SDL_GPUTextureCreateInfo info = {};
+  info.type                     = SDL_GPU_TEXTURETYPE_2D;
+  info.width                    = static_cast<int>(size.X);
+  info.height                   = static_cast<int>(size.Y);
+  info.layer_count_or_depth     = 1;
+  info.num_levels               = 1;
+  info.format                   = format;
+  info.usage                    = usage;
+  auto new_texture              = SDL_CreateGPUTexture(as->device, &info);
+  if (new_texture == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create texture: %s", SDL_GetError());
+    return false;
+  }
+
+  gpu_release_queue_push(&as->release_queue, GPU_OBJECT_KIND_TEXTURE, *texture);
+  *texture = new_texture;
+
+  return true;
+}
+
+// A render pass target in the swapchain format at the window size, that later passes can sample.
+static bool init_window_sized_texture(App_State* as, SDL_GPUTexture** texture) {
+  return init_texture(
+      as,
+      texture,
+      as->window_size_pixels,
+      as->swapchain_texture_format,
+      SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER);
+}
+
+static bool init_compute_target(App_State* as) {
+  return init_texture(
+      as,
+      &as->compute_target,
+      as->window_size_pixels,
+      SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+      SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE | SDL_GPU_TEXTUREUSAGE_SAMPLER);
+}
+
+// Only the first texture of the cache is needed until it is enabled.
+static bool init_warp_field(App_State* as) {
+  auto cache = &as->warp_field_cache;
+  auto size  = HMM_V2(
+      SDL_ceilf(as->window_size_pixels.X * WARP_FIELD_MAX_SCALE),
+      SDL_ceilf(as->window_size_pixels.Y * WARP_FIELD_MAX_SCALE));
+  for (int i = 0; i < static_cast<int>(cache->textures.size()); i++) {
+    if (i > 0 && !cache->enabled && cache->textures[i] == nullptr) { continue; }
+    if (!init_texture(
+            as,
+            &cache->textures[i],
+            size,
+            WARP_FIELD_TEXTURE_FORMAT,
+            SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER)) {
       return false;
     }
-  };
+  }
+  cache->texture_size = size;
+  warp_field_cache_invalidate(cache);
 
-  SDL_ReleaseGPUTexture(as->device, as->render_target);
-  as->render_target = render_target;
+  return true;
+}
+
+static bool uses_ring_hearts(App_State* as) {
+  return SHADER_KIND_PREPARE_FUNCS[as->shader_kind] == plasma_beat_prepare;
+}
+
+static bool uses_warp_field(App_State* as) {
+  return SHADER_KIND_RESOURCE_IDS[as->shader_kind] == RESOURCE_ID_SHADER_FRAGMENT_FBM_WARP_CACHED;
+}
+
+static HMM_Vec2 warp_field_size(App_State* as) {
+  auto scale = WARP_FIELD_MODES[as->warp_field_mode_index].scale;
+  return HMM_V2(SDL_ceilf(as->render_size.X * scale), SDL_ceilf(as->render_size.Y * scale));
+}
+
+// fbm_warp evaluates five fbms per pixel, two for q, two for r and the pattern itself.
+// fbm_warp_cached moves those of q, and optionally r, to the field, which the cache renders once
+// per interval.
+static float warp_field_fbms_per_pixel(App_State* as) {
+  const auto& mode        = WARP_FIELD_MODES[as->warp_field_mode_index];
+  const auto& cache       = as->warp_field_cache;
+  auto        field_fbms  = mode.cache_r ? 4.0f : 2.0f;
+  auto        field_ratio = mode.scale * mode.scale;
+  if (cache.enabled) { field_ratio /= static_cast<float>(cache.interval_frames); }
+  return 5.0f - field_fbms + field_fbms * field_ratio;
+}
+
+static bool init_checkerboard_textures(App_State* as) {
+  if (!init_window_sized_texture(as, &as->checkerboard_field)) { return false; }
+  for (auto& texture : as->checkerboard_history) {
+    if (!init_window_sized_texture(as, &texture)) { return false; }
+  }
+  as->checkerboard_history_frame = 0;
+
+  return true;
+}
+
+static bool init_render_texture(App_State* as) {
+  if (!init_window_sized_texture(as, &as->render_target)) { return false; }
+  // Only read by the upscaler, which needs a window.
+  if (!as->headless && !init_window_sized_texture(as, &as->upscale_target)) { return false; }
+  if (as->checkerboard_field != nullptr && !init_checkerboard_textures(as)) { return false; }
+  if (as->compute_target != nullptr && !init_compute_target(as)) { return false; }
+  if (as->warp_field_cache.textures[0] != nullptr && !init_warp_field(as)) { return false; }
+  update_render_size(as);
 
   return true;
 }
 
-static bool init_pipeline(App_State* as, Shader_Kind shader_kind) {
+// Safe to call from any thread.
+static SDL_GPUGraphicsPipeline* create_pipeline(
+    SDL_GPUDevice*       device,
+    SDL_GPUTextureFormat format,
+    SDL_GPUShader*       vertex_shader,
+    SDL_GPUShader*       fragment_shader) {
   SDL_GPUColorTargetDescription desc = {};
-  desc.format                        = as->swapchain_texture_format;
+  desc.format                        = format;
 
   SDL_GPUGraphicsPipelineCreateInfo info     = {};
   info.target_info.num_color_targets         = 1;
   info.target_info.color_target_descriptions = &desc;
   info.primitive_type                        = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
-  info.vertex_shader =
-      resources_get(as->resources, RESOURCE_ID_SHADER_VERTEX_FULLSCREEN).shader.handle;
-  info.fragment_shader =
-      resources_get(as->resources, SHADER_KIND_RESOURCE_IDS[shader_kind]).shader.handle;
-  auto pipeline = SDL_CreateGPUGraphicsPipeline(as->device, &info);
+  info.vertex_shader                         = vertex_shader;
+  info.fragment_shader                       = fragment_shader;
+  auto pipeline                              = SDL_CreateGPUGraphicsPipeline(device, &info);
   if (pipeline == nullptr) {
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create pipeline: %s", SDL_GetError());
-    return false;
   }
 
-  SDL_ReleaseGPUGraphicsPipeline(as->device, as->pipelines[shader_kind]);
-  as->pipelines[shader_kind] = pipeline;
+  return pipeline;
+}
+
+// Pass pipelines are created synchronously, at startup and after a reload of their shaders.
+static bool init_pass_pipeline(App_State* as, Pass_Pipeline pass) {
+  // The warp field is the only pass that doesn't draw in the swapchain format.
+  auto format = pass == PASS_PIPELINE_FBM_WARP_FIELD ? WARP_FIELD_TEXTURE_FORMAT
+                                                     : as->swapchain_texture_format;
+
+  const auto& shaders  = PIPELINE_SHADERS[SHADER_KIND_COUNT + pass];
+  auto        pipeline = create_pipeline(
+      as->device,
+      format,
+      resources_get(as->resources, shaders.vertex_id).shader.handle,
+      resources_get(as->resources, shaders.fragment_id).shader.handle);
+  if (pipeline == nullptr) { return false; }
+
+  gpu_release_queue_push(
+      &as->release_queue,
+      GPU_OBJECT_KIND_GRAPHICS_PIPELINE,
+      as->pass_pipelines[pass]);
+  as->pass_pipelines[pass] = pipeline;
+  as->pipeline_builds_count += 1;
 
   return true;
 }
 
+static void pipeline_job(void* user_data) {
+  auto slot     = static_cast<Pipeline_Slot*>(user_data);
+  slot->created = create_pipeline(
+      slot->device,
+      slot->format,
+      slot->vertex_shader,
+      slot->fragment_shader);
+  SDL_SetAtomicInt(&slot->state, PIPELINE_STATE_DONE);
+}
+
+// Queues the creation of the pipeline for a shader kind, with its picked variant, unless it is
+// already up to date, in flight or failed to build. Loads the variant first if needs be.
+static void request_pipeline(App_State* as, Shader_Kind shader_kind) {
+  auto slot         = &as->pipelines[shader_kind];
+  auto variant_mask = as->shader_kind_variant_masks[shader_kind];
+  if (slot->pipeline != nullptr && !slot->outdated && slot->variant_mask == variant_mask) {
+    return;
+  }
+  if (slot->failed[variant_mask]) { return; }
+  if (SDL_GetAtomicInt(&slot->state) != PIPELINE_STATE_IDLE) { return; }
+
+  const auto& shaders         = PIPELINE_SHADERS[shader_kind];
+  const auto& vertex_shader   = resources_get(as->resources, shaders.vertex_id);
+  const auto  fragment_shader = resources_request_variant(
+      &as->resources,
+      &as->job_pool,
+      as->title_storage,
+      shaders.fragment_id,
+      variant_mask);
+  if (fragment_shader == nullptr) { return; }
+
+  slot->device               = as->device;
+  slot->format               = as->swapchain_texture_format;
+  slot->vertex_shader        = vertex_shader.shader.handle;
+  slot->fragment_shader      = fragment_shader->shader.handle;
+  slot->created_variant_mask = variant_mask;
+  slot->created              = nullptr;
+  slot->outdated             = false;
+  slot->start_ticks          = SDL_GetTicks();
+  SDL_SetAtomicInt(&slot->state, PIPELINE_STATE_PENDING);
+
+  job_pool_push(&as->job_pool, pipeline_job, slot);
+}
+
+// Switches the compute version of a shader kind to its picked variant once that has been loaded,
+// until then the one in use stays.
+static void request_compute_variant(App_State* as, Shader_Kind shader_kind) {
+  auto compute_id   = SHADER_KIND_COMPUTE_RESOURCE_IDS[shader_kind];
+  auto variant_mask = as->shader_kind_variant_masks[shader_kind];
+  if (compute_id == RESOURCE_ID_COUNT || as->compute_variant_masks[shader_kind] == variant_mask) {
+    return;
+  }
+
+  auto compute = resources_request_variant(
+      &as->resources,
+      &as->job_pool,
+      as->title_storage,
+      compute_id,
+      variant_mask);
+  if (compute != nullptr) { as->compute_variant_masks[shader_kind] = variant_mask; }
+}
+
+// Picks up the variants and pipelines finished since the last frame, and makes sure the selected
+// shader kind and the one after it (the likely next pick) are being built.
+static void update_pipelines(App_State* as) {
+  resources_update_variants(&as->resources, as->device);
+
+  for (int i = 0; i < SHADER_KIND_COUNT; i++) {
+    auto slot = &as->pipelines[i];
+    if (SDL_GetAtomicInt(&slot->state) != PIPELINE_STATE_DONE) { continue; }
+
+    if (slot->created != nullptr) {
+      gpu_release_queue_push(&as->release_queue, GPU_OBJECT_KIND_GRAPHICS_PIPELINE, slot->pipeline);
+      slot->pipeline     = slot->created;
+      slot->variant_mask = slot->created_variant_mask;
+      as->pipeline_builds_count += 1;
+      SDL_LogInfo(
+          SDL_LOG_CATEGORY_APPLICATION,
+          "Created pipeline %s in %llu ms",
+          RESOURCES_INFO[SHADER_KIND_RESOURCE_IDS[i]].file_name,
+          static_cast<unsigned long long>(SDL_GetTicks() - slot->start_ticks));
+    } else {
+      slot->failed[slot->created_variant_mask] = true;
+    }
+    slot->created = nullptr;
+    SDL_SetAtomicInt(&slot->state, PIPELINE_STATE_IDLE);
+  }
+
+  request_pipeline(as, as->shader_kind);
+  request_pipeline(as, (as->shader_kind + 1) % SHADER_KIND_COUNT);
+  if (as->compute_path) { request_compute_variant(as, as->shader_kind); }
+
+  auto ticks = SDL_GetTicks();
+  if (ticks - as->pipeline_builds_window_start_ticks >= 1000) {
+    as->pipeline_builds_per_second         = as->pipeline_builds_count;
+    as->pipeline_builds_count              = 0;
+    as->pipeline_builds_window_start_ticks = ticks;
+  }
+}
+
+// Whether the shader kind draws with its picked variant, or never will because that failed.
+static bool picked_variant_settled(App_State* as) {
+  const auto& slot         = as->pipelines[as->shader_kind];
+  auto        variant_mask = as->shader_kind_variant_masks[as->shader_kind];
+  auto        fragment_id  = SHADER_KIND_RESOURCE_IDS[as->shader_kind];
+  if (slot.failed[variant_mask] ||
+      resources_variant_failed(&as->resources, fragment_id, variant_mask)) {
+    return true;
+  }
+  if (slot.pipeline == nullptr || slot.variant_mask != variant_mask) { return false; }
+
+  auto compute_id = SHADER_KIND_COMPUTE_RESOURCE_IDS[as->shader_kind];
+  return !as->compute_path || compute_id == RESOURCE_ID_COUNT ||
+         as->compute_variant_masks[as->shader_kind] == variant_mask ||
+         resources_variant_failed(&as->resources, compute_id, variant_mask);
+}
+
+#ifdef BUILD_DEBUG
+static bool pipelines_pending(App_State* as) {
+  for (auto& slot : as->pipelines) {
+    if (SDL_GetAtomicInt(&slot.state) != PIPELINE_STATE_IDLE) { return true; }
+  }
+
+  return false;
+}
+
+// Marks the pipeline of a shader kind as built from a reloaded shader. The old pipeline stays bound
+// until the new one has been created, as pipelines don't reference the shaders they were created
+// from.
+static void invalidate_pipeline(App_State* as, Shader_Kind shader_kind) {
+  auto slot      = &as->pipelines[shader_kind];
+  slot->outdated = slot->pipeline != nullptr;
+  slot->failed   = {};
+}
+#endif
+
 static bool on_window_pixel_size_changed(App_State* as, int width, int height) {
   if (as->window_size_pixels.X == width && as->window_size_pixels.Y == height) { return true; }
   as->window_size_pixels = HMM_V2(width, height);
@@ -154,57 +846,8 @@ static void on_vsync_changed(App_State* as, bool vsync) {
       present_mode);
 }
 
-SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[]) {
-  if (!SDL_Init(SDL_INIT_VIDEO)) {
-    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to init SDL: %s", SDL_GetError());
-    return SDL_APP_FAILURE;
-  }
-
-  auto as = new (std::nothrow) App_State {};
-  if (as == nullptr) {
-    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate App_State");
-    return SDL_APP_FAILURE;
-  }
-  *appstate = as;
-
-#ifdef BUILD_DEBUG
-  std::string base_path = RESOURCES_PATH;
-#else
-  auto base_path_ptr = SDL_GetBasePath();
-  if (base_path_ptr == nullptr) {
-    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to get base path: %s", SDL_GetError());
-    return SDL_APP_FAILURE;
-  }
-  std::string base_path = base_path_ptr;
-#endif
-  as->title_storage = SDL_OpenTitleStorage(base_path.c_str(), 0);
-  if (as->title_storage == nullptr) {
-    SDL_LogError(
-        SDL_LOG_CATEGORY_APPLICATION,
-        "Failed to get open title stotage: %s",
-        SDL_GetError());
-    return SDL_APP_FAILURE;
-  }
-  while (!SDL_StorageReady(as->title_storage)) { SDL_Delay(1); }
-
-  SDL_GPUShaderFormat format_flags = 0;
-#ifdef SDL_PLATFORM_WINDOWS
-  format_flags |= SDL_GPU_SHADERFORMAT_DXIL;
-#elif SDL_PLATFORM_LINUX
-  format_flags |= SDL_GPU_SHADERFORMAT_SPIRV;
-#else
-#error "Platform not supported"
-#endif
-  bool debug = false;
-#ifdef BUILD_DEBUG
-  debug = true;
-#endif
-  as->device = SDL_CreateGPUDevice(format_flags, debug, nullptr);
-  if (as->device == nullptr) {
-    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create gpu device: %s", SDL_GetError());
-    return SDL_APP_FAILURE;
-  }
-
+// Creates the window, claims it for the GPU device and sets up ImGui. Not used in headless mode.
+static bool init_window(App_State* as) {
   int   window_width       = 800;
   int   window_height      = 600;
   float content_scale      = 1.0f;
@@ -232,7 +875,7 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[]) {
       SDL_WINDOW_RESIZABLE | SDL_WINDOW_HIGH_PIXEL_DENSITY);
   if (as->window == nullptr) {
     SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create window: %s", SDL_GetError());
-    return SDL_APP_FAILURE;
+    return false;
   }
 
   if (!SDL_ClaimWindowForGPUDevice(as->device, as->window)) {
@@ -240,7 +883,7 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[]) {
         SDL_LOG_CATEGORY_APPLICATION,
         "Failed to claim window for gpu device: %s",
         SDL_GetError());
-    return SDL_APP_FAILURE;
+    return false;
   }
 
   as->swapchain_texture_format = SDL_GetGPUSwapchainTextureFormat(as->device, as->window);
@@ -272,17 +915,230 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[]) {
     ImGui_ImplSDLGPU3_Init(&init_info);
   }
 
-  if (!resources_load(&as->resources, as->device, as->title_storage)) {
-    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load resources");
+  return true;
+}
+
+SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[]) {
+  if (!alloc_tracker_init()) { return SDL_APP_FAILURE; }
+
+  App_Args args;
+  if (!parse_args(&args, argc, argv)) { return SDL_APP_FAILURE; }
+
+  Shader_Kind shader_kind = 0;
+  if (args.shader_name != nullptr) {
+    shader_kind = -1;
+    for (int i = 0; i < SHADER_KIND_COUNT; i++) {
+      const auto& info = RESOURCES_INFO[SHADER_KIND_RESOURCE_IDS[i]];
+      if (SDL_strcmp(info.file_name, args.shader_name) == 0) { shader_kind = i; }
+    }
+    if (shader_kind < 0) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unknown shader: %s", args.shader_name);
+      return SDL_APP_FAILURE;
+    }
+  }
+  int warp_field_mode_index = 0;
+  if (args.warp_field_mode_name != nullptr) {
+    warp_field_mode_index = -1;
+    for (int i = 0; i < static_cast<int>(WARP_FIELD_MODES.size()); i++) {
+      if (SDL_strcmp(WARP_FIELD_MODES[i].name, args.warp_field_mode_name) == 0) {
+        warp_field_mode_index = i;
+      }
+    }
+    if (warp_field_mode_index < 0) {
+      SDL_LogError(
+          SDL_LOG_CATEGORY_APPLICATION,
+          "Unknown warp field mode: %s",
+          args.warp_field_mode_name);
+      return SDL_APP_FAILURE;
+    }
+  }
+
+  std::array<Shader_Variant_Mask, SHADER_KIND_COUNT> shader_kind_variant_masks = {};
+  for (int i = 0; i < args.shader_defines_count; i++) {
+    bool declared = false;
+    for (int j = 0; j < SHADER_KIND_COUNT; j++) {
+      const auto& axes = RESOURCES_PERMUTATION_AXES[SHADER_KIND_RESOURCE_IDS[j]];
+      for (int k = 0; k < shader_permutation_axes_count(axes); k++) {
+        if (SDL_strcmp(axes[k], args.shader_defines[i]) != 0) { continue; }
+        shader_kind_variant_masks[j] |= 1u << k;
+        declared = true;
+      }
+    }
+    if (!declared) {
+      SDL_LogError(
+          SDL_LOG_CATEGORY_APPLICATION,
+          "No shader kind has the permutation axis %s",
+          args.shader_defines[i]);
+      return SDL_APP_FAILURE;
+    }
+  }
+
+  // The offscreen video driver still loads Vulkan, but doesn't need a display.
+  if (args.headless) { SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen"); }
+  if (!SDL_Init(SDL_INIT_VIDEO)) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to init SDL: %s", SDL_GetError());
     return SDL_APP_FAILURE;
   }
 
-  for (int i = 0; i < SHADER_KIND_COUNT; i++) {
-    if (!init_pipeline(as, static_cast<Shader_Kind>(i))) { return SDL_APP_FAILURE; }
+  auto as = new (std::nothrow) App_State {};
+  if (as == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate App_State");
+    return SDL_APP_FAILURE;
+  }
+  *appstate = as;
+
+#ifdef BUILD_DEBUG
+  std::string base_path = RESOURCES_PATH;
+#else
+  auto base_path_ptr = SDL_GetBasePath();
+  if (base_path_ptr == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to get base path: %s", SDL_GetError());
+    return SDL_APP_FAILURE;
+  }
+  std::string base_path = base_path_ptr;
+#endif
+  as->title_storage = SDL_OpenTitleStorage(base_path.c_str(), 0);
+  if (as->title_storage == nullptr) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to get open title stotage: %s",
+        SDL_GetError());
+    return SDL_APP_FAILURE;
+  }
+  while (!SDL_StorageReady(as->title_storage)) { SDL_Delay(1); }
+
+  SDL_GPUShaderFormat format_flags = 0;
+#ifdef SDL_PLATFORM_WINDOWS
+  format_flags |= SDL_GPU_SHADERFORMAT_DXIL;
+#elif SDL_PLATFORM_LINUX
+  format_flags |= SDL_GPU_SHADERFORMAT_SPIRV;
+#else
+#error "Platform not supported"
+#endif
+  bool debug = false;
+#ifdef BUILD_DEBUG
+  debug = true;
+#endif
+  as->device = SDL_CreateGPUDevice(format_flags, debug, nullptr);
+  if (as->device == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create gpu device: %s", SDL_GetError());
+    return SDL_APP_FAILURE;
+  }
+
+  if (args.headless) {
+    as->headless                 = true;
+    as->swapchain_texture_format = HEADLESS_TEXTURE_FORMAT;
+  } else if (!init_window(as)) {
+    return SDL_APP_FAILURE;
+  }
+
+  as->shader_kind               = shader_kind;
+  as->alloc_check_warmup_frames = args.alloc_check_warmup_frames;
+  as->frames_limit              = static_cast<uint64_t>(args.frames_limit);
+  as->compute_path              = args.compute_path;
+  as->warp_field_mode_index     = warp_field_mode_index;
+  as->warp_field_cache.enabled  = args.warp_field_temporal;
+  as->ring_hearts_count         = args.ring_hearts_count;
+  as->cull_ring_hearts          = args.cull_ring_hearts;
+  as->shader_kind_variant_masks = shader_kind_variant_masks;
+  if (args.bench_output_path != nullptr) {
+    // The benchmark stops by itself, --frames sets the measured frames of each case instead.
+    as->benchmarking               = true;
+    as->frames_limit               = 0;
+    as->vsync                      = false;
+    as->dynamic_resolution.enabled = false;
+    bench_init(&as->bench, args.bench_output_path, args.frames_limit);
+  }
+  if (as->headless && !as->benchmarking) {
+    as->frame_times_ms.reserve(as->frames_limit > 0 ? as->frames_limit : 4096);
+  }
+
+  {
+    // The upscaler passes read exact texels, clamped to the viewport by hand.
+    SDL_GPUSamplerCreateInfo info = {};
+    info.min_filter               = SDL_GPU_FILTER_NEAREST;
+    info.mag_filter               = SDL_GPU_FILTER_NEAREST;
+    info.mipmap_mode              = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST;
+    info.address_mode_u           = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE;
+    info.address_mode_v           = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE;
+    info.address_mode_w           = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE;
+    as->point_sampler             = SDL_CreateGPUSampler(as->device, &info);
+    if (as->point_sampler == nullptr) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create sampler: %s", SDL_GetError());
+      return SDL_APP_FAILURE;
+    }
   }
 
-  on_vsync_changed(as, as->vsync);
   {
+    // The generated textures tile.
+    SDL_GPUSamplerCreateInfo info = {};
+    info.min_filter               = SDL_GPU_FILTER_NEAREST;
+    info.mag_filter               = SDL_GPU_FILTER_NEAREST;
+    info.mipmap_mode              = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST;
+    info.address_mode_u           = SDL_GPU_SAMPLERADDRESSMODE_REPEAT;
+    info.address_mode_v           = SDL_GPU_SAMPLERADDRESSMODE_REPEAT;
+    info.address_mode_w           = SDL_GPU_SAMPLERADDRESSMODE_REPEAT;
+    as->repeat_sampler            = SDL_CreateGPUSampler(as->device, &info);
+    if (as->repeat_sampler == nullptr) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create sampler: %s", SDL_GetError());
+      return SDL_APP_FAILURE;
+    }
+  }
+
+  {
+    // The warp field is filtered, and clamped to its region by hand.
+    SDL_GPUSamplerCreateInfo info = {};
+    info.min_filter               = SDL_GPU_FILTER_LINEAR;
+    info.mag_filter               = SDL_GPU_FILTER_LINEAR;
+    info.mipmap_mode              = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST;
+    info.address_mode_u           = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE;
+    info.address_mode_v           = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE;
+    info.address_mode_w           = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE;
+    as->linear_sampler            = SDL_CreateGPUSampler(as->device, &info);
+    if (as->linear_sampler == nullptr) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create sampler: %s", SDL_GetError());
+      return SDL_APP_FAILURE;
+    }
+  }
+
+  if (!job_pool_init(&as->job_pool, args.load_threads_count)) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to init job pool");
+    return SDL_APP_FAILURE;
+  }
+
+  if (!resources_load(&as->resources, as->device, as->title_storage, &as->job_pool)) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load resources");
+    return SDL_APP_FAILURE;
+  }
+#ifdef BUILD_DEBUG
+  if (!resources_watch(&as->resources, base_path.c_str())) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to watch resources");
+    return SDL_APP_FAILURE;
+  }
+#endif
+
+  // Only the pass pipelines are created up front; the pipeline of the selected shader kind is
+  // created on the job pool while the first frames are drawn.
+  for (int i = 0; i < PASS_PIPELINE_COUNT; i++) {
+    if (!init_pass_pipeline(as, static_cast<Pass_Pipeline>(i))) { return SDL_APP_FAILURE; }
+  }
+  update_pipelines(as);
+
+  if (as->headless) {
+    // Timings are only meaningful for the real pipeline, so wait for it (and its variant, which is
+    // loaded first) rather than drawing the placeholder.
+    while (!picked_variant_settled(as)) {
+      job_pool_wait(&as->job_pool);
+      update_pipelines(as);
+    }
+
+    as->window_size_pixels = HMM_V2(args.headless_width, args.headless_height);
+    if (!init_render_texture(as)) {
+      SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create render target");
+      return SDL_APP_FAILURE;
+    }
+  } else {
+    on_vsync_changed(as, as->vsync);
     int w, h;
     SDL_GetWindowSizeInPixels(as->window, &w, &h);
     if (!on_window_pixel_size_changed(as, w, h)) { return SDL_APP_FAILURE; }
@@ -297,6 +1153,7 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[]) {
 
 SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event) {
   auto as = static_cast<App_State*>(appstate);
+  if (as->headless) { return event->type == SDL_EVENT_QUIT ? SDL_APP_SUCCESS : SDL_APP_CONTINUE; }
 
   auto& io                  = ImGui::GetIO();
   bool  process_imgui_event = true;
@@ -346,83 +1203,727 @@ static void draw_imgui(App_State* as) {
 
     ImGui::Separator();
 
-    static constexpr const char* shader_kind_strings[SHADER_KIND_COUNT] = {
-        "FBM Warp",
-        "Plasma Beat",
+    auto shader_kind_string = [](Shader_Kind shader_kind) {
+      return RESOURCES_INFO[SHADER_KIND_RESOURCE_IDS[shader_kind]].file_name;
     };
-    if (ImGui::BeginCombo("Shader Selection", shader_kind_strings[as->shader_kind])) {
+    if (ImGui::BeginCombo("Shader Selection", shader_kind_string(as->shader_kind))) {
       for (int i = 0; i < SHADER_KIND_COUNT; i++) {
         bool is_selected = as->shader_kind == i;
-        if (ImGui::Selectable(shader_kind_strings[i], is_selected)) {
-          as->shader_kind = static_cast<Shader_Kind>(i);
+        if (ImGui::Selectable(shader_kind_string(i), is_selected)) { as->shader_kind = i; }
+        if (is_selected) { ImGui::SetItemDefaultFocus(); }
+      }
+      ImGui::EndCombo();
+    }
+    static constexpr std::array<const char*, CHECKERBOARD_MODE_COUNT> checkerboard_mode_strings = {
+        "Off",
+        "On",
+        "Show Error",
+    };
+    auto checkerboard_mode = &as->checkerboard_modes[as->shader_kind];
+    if (ImGui::BeginCombo("Checkerboard", checkerboard_mode_strings[*checkerboard_mode])) {
+      for (int i = 0; i < CHECKERBOARD_MODE_COUNT; i++) {
+        bool is_selected = *checkerboard_mode == i;
+        if (ImGui::Selectable(checkerboard_mode_strings[i], is_selected)) {
+          *checkerboard_mode = static_cast<Checkerboard_Mode>(i);
         }
         if (is_selected) { ImGui::SetItemDefaultFocus(); }
       }
       ImGui::EndCombo();
     }
+    if (SHADER_KIND_COMPUTE_RESOURCE_IDS[as->shader_kind] != RESOURCE_ID_COUNT) {
+      ImGui::Checkbox("Compute Path", &as->compute_path);
+      if (as->compute_path && *checkerboard_mode != CHECKERBOARD_MODE_OFF) {
+        ImGui::TextDisabled("The compute path doesn't checkerboard");
+      }
+    }
+    if (uses_warp_field(as)) {
+      const auto& mode = WARP_FIELD_MODES[as->warp_field_mode_index];
+      if (ImGui::BeginCombo("Warp Field", mode.label)) {
+        for (int i = 0; i < static_cast<int>(WARP_FIELD_MODES.size()); i++) {
+          bool is_selected = as->warp_field_mode_index == i;
+          if (ImGui::Selectable(WARP_FIELD_MODES[i].label, is_selected)) {
+            as->warp_field_mode_index = i;
+          }
+          if (is_selected) { ImGui::SetItemDefaultFocus(); }
+        }
+        ImGui::EndCombo();
+      }
+      ImGui::Checkbox("Show Warp Field Error", &as->warp_field_show_error);
+      ImGui::Checkbox("Temporal Warp Field", &as->warp_field_cache.enabled);
+      auto field_size = warp_field_size(as);
+      ImGui::Text(
+          "Field %dx%d, %.2f fbms per pixel (fbm_warp: 5)",
+          static_cast<int>(field_size.X),
+          static_cast<int>(field_size.Y),
+          warp_field_fbms_per_pixel(as));
+      if (as->warp_field_cache.enabled) {
+        ImGui::Text(
+            "Refreshed over %d frames, blending %.2f",
+            as->warp_field_cache.interval_frames,
+            as->warp_field_frame.blend);
+      }
+    }
+    if (uses_ring_hearts(as)) {
+      ImGui::SliderInt("Ring Hearts", &as->ring_hearts_count, 1, PLASMA_BEAT_RING_HEARTS_MAX_COUNT);
+      ImGui::Checkbox("Cull Ring Hearts", &as->cull_ring_hearts);
+    }
 
-    static constexpr std::array<const char*, RENDER_TARGET_SCALE_VALUES.size()>
-        render_scale_strings = {
-            "100%",
-            "90%",
-            "80%",
-            "75%",
-            "50%",
-        };
-    if (ImGui::BeginCombo("Render Scale", render_scale_strings[as->render_scale_index])) {
-      for (int i = 0; i < RENDER_TARGET_SCALE_VALUES.size(); i++) {
-        bool is_selected = as->render_scale_index == i;
-        if (ImGui::Selectable(render_scale_strings[i], is_selected)) {
-          if (as->render_scale_index != i) {
+    auto        fragment_id  = SHADER_KIND_RESOURCE_IDS[as->shader_kind];
+    const auto& axes         = RESOURCES_PERMUTATION_AXES[fragment_id];
+    auto&       variant_mask = as->shader_kind_variant_masks[as->shader_kind];
+    for (int i = 0; i < shader_permutation_axes_count(axes); i++) {
+      bool defined = (variant_mask & (1u << i)) != 0;
+      if (ImGui::Checkbox(axes[i], &defined)) { variant_mask ^= 1u << i; }
+    }
+    const auto& pipeline_slot = as->pipelines[as->shader_kind];
+    if (pipeline_slot.failed[variant_mask]) {
+      ImGui::TextDisabled("Failed to create pipeline");
+    } else if (resources_variant_failed(&as->resources, fragment_id, variant_mask)) {
+      ImGui::TextDisabled("Failed to compile variant");
+    } else if (pipeline_slot.pipeline == nullptr) {
+      ImGui::TextDisabled("Creating pipeline...");
+    } else if (pipeline_slot.variant_mask != variant_mask) {
+      ImGui::TextDisabled("Compiling variant...");
+    }
+    ImGui::Text("Pipeline builds: %d/s", as->pipeline_builds_per_second);
+    ImGui::Text(
+        "GPU objects pending release: %d",
+        static_cast<int>(as->release_queue.objects.size()));
+#ifdef BUILD_ALLOC_TRACKER
+    ImGui::Text("Allocations last frame:");
+    for (int i = ALLOC_PHASE_NONE + 1; i < ALLOC_PHASE_COUNT; i++) {
+      ImGui::BulletText(
+          "%s: %d (%d bytes)",
+          ALLOC_PHASE_NAMES[i],
+          static_cast<int>(as->alloc_stats.counts[i]),
+          static_cast<int>(as->alloc_stats.bytes[i]));
+    }
+#endif
+
+    auto dr = &as->dynamic_resolution;
+    if (ImGui::Checkbox("Dynamic Resolution", &dr->enabled) && dr->enabled) {
+      dr->scale = RENDER_TARGET_SCALE_VALUES[as->render_scale_index];
+    }
+    if (dr->enabled) {
+      static constexpr std::array<const char*, DYNAMIC_RESOLUTION_BUDGETS_MS.size()>
+          budget_strings = {
+              "16.6 ms (60 FPS)",
+              "8.3 ms (120 FPS)",
+          };
+      if (ImGui::BeginCombo("Frame Budget", budget_strings[dr->budget_index])) {
+        for (int i = 0; i < static_cast<int>(DYNAMIC_RESOLUTION_BUDGETS_MS.size()); i++) {
+          bool is_selected = dr->budget_index == i;
+          if (ImGui::Selectable(budget_strings[i], is_selected)) { dr->budget_index = i; }
+          if (is_selected) { ImGui::SetItemDefaultFocus(); }
+        }
+        ImGui::EndCombo();
+      }
+      ImGui::Text(
+          "Render scale: %.0f%% (%.2f ms smoothed)",
+          dr->scale * 100.0f,
+          dr->smoothed_frame_ms);
+    } else {
+      static constexpr std::array<const char*, RENDER_TARGET_SCALE_VALUES.size()>
+          render_scale_strings = {
+              "100%",
+              "90%",
+              "80%",
+              "75%",
+              "50%",
+          };
+      if (ImGui::BeginCombo("Render Scale", render_scale_strings[as->render_scale_index])) {
+        for (int i = 0; i < RENDER_TARGET_SCALE_VALUES.size(); i++) {
+          bool is_selected = as->render_scale_index == i;
+          if (ImGui::Selectable(render_scale_strings[i], is_selected)) {
             as->render_scale_index = i;
-            if (!init_render_texture(as)) {
-              SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create render target");
-            }
           }
+          if (is_selected) { ImGui::SetItemDefaultFocus(); }
+        }
+        ImGui::EndCombo();
+      }
+    }
+
+    static constexpr std::array<const char*, UPSCALER_COUNT> upscaler_strings = {
+        "Bilinear",
+        "EASU + RCAS",
+    };
+    if (ImGui::BeginCombo("Upscaler", upscaler_strings[as->upscaler])) {
+      for (int i = 0; i < UPSCALER_COUNT; i++) {
+        bool is_selected = as->upscaler == i;
+        if (ImGui::Selectable(upscaler_strings[i], is_selected)) {
+          as->upscaler = static_cast<Upscaler>(i);
         }
         if (is_selected) { ImGui::SetItemDefaultFocus(); }
       }
       ImGui::EndCombo();
     }
+    if (as->upscaler == UPSCALER_EASU_RCAS) {
+      ImGui::SliderFloat("Sharpness", &as->sharpness, 0.0f, 2.0f, "%.2f stops (0 is sharpest)");
+    }
+
+#ifdef BUILD_DEBUG
+    ImGui::Separator();
+
+    auto cache = &as->resources.shader_cache;
+    ImGui::Text(
+        "Shader cache: %d hits, %d misses, %.2f s compiling",
+        SDL_GetAtomicInt(&cache->hits),
+        SDL_GetAtomicInt(&cache->misses),
+        static_cast<float>(SDL_GetAtomicInt(&cache->compile_time_ms)) / 1000.0f);
+    ImGui::Text(
+        "Shader compiles: %d running, %d queued",
+        SDL_GetAtomicInt(&as->job_pool.running_count),
+        SDL_GetAtomicInt(&as->job_pool.queued_count));
+    for (int i = 0; i < RESOURCE_ID_COUNT; i++) {
+      const auto& job   = as->resources.compile_jobs[i];
+      auto        state = SDL_GetAtomicInt(const_cast<SDL_AtomicInt*>(&job.state));
+      if (state == SHADER_COMPILE_STATE_QUEUED) {
+        ImGui::BulletText("%s: queued", RESOURCES_INFO[i].file_name);
+      } else if (state == SHADER_COMPILE_STATE_RUNNING) {
+        ImGui::BulletText(
+            "%s: compiling (%.1f s)",
+            RESOURCES_INFO[i].file_name,
+            static_cast<float>(SDL_GetTicks() - job.start_ticks) / 1000.0f);
+      }
+    }
+#endif
   }
   ImGui::End();
 }
 
+static void push_warp_field_uniforms(App_State* as, SDL_GPUCommandBuffer* cmd_buf) {
+  Warp_Field_Uniforms uniforms = {};
+  uniforms.field_size          = warp_field_size(as);
+  uniforms.field_texture_size  = as->warp_field_cache.texture_size;
+  uniforms.cache_r             = WARP_FIELD_MODES[as->warp_field_mode_index].cache_r ? 1.0f : 0.0f;
+  uniforms.show_error          = as->warp_field_show_error ? 1.0f : 0.0f;
+  uniforms.field_blend         = as->warp_field_frame.blend;
+  SDL_PushGPUFragmentUniformData(cmd_buf, 1, &uniforms, sizeof(uniforms));
+}
+
+// Renders bands of the warp field of fbm_warp_cached, over the warp_field_size region of one of
+// the cache textures. The rest of a partly rendered texture is kept.
+static void record_warp_field_pass(
+    App_State*               as,
+    SDL_GPUCommandBuffer*    cmd_buf,
+    const Warp_Field_Render& render) {
+  bool whole = render.first_band == 0 && render.bands_end == WARP_FIELD_CACHE_BANDS_COUNT;
+
+  SDL_GPUColorTargetInfo target_info = {};
+  target_info.texture                = as->warp_field_cache.textures[render.texture];
+  target_info.load_op                = whole ? SDL_GPU_LOADOP_DONT_CARE : SDL_GPU_LOADOP_LOAD;
+  target_info.store_op               = SDL_GPU_STOREOP_STORE;
+  SDL_GPURenderPass* render_pass     = SDL_BeginGPURenderPass(cmd_buf, &target_info, 1, nullptr);
+  defer(SDL_EndGPURenderPass(render_pass));
+
+  auto field_size = warp_field_size(as);
+
+  SDL_GPUViewport viewport = {};
+  viewport.w               = field_size.X;
+  viewport.h               = field_size.Y;
+  viewport.max_depth       = 1.0f;
+  SDL_SetGPUViewport(render_pass, &viewport);
+
+  auto band_height  = static_cast<int>(SDL_ceilf(field_size.Y / WARP_FIELD_CACHE_BANDS_COUNT));
+  auto bands_top    = render.first_band * band_height;
+  auto bands_bottom = SDL_min(render.bands_end * band_height, static_cast<int>(field_size.Y));
+
+  SDL_Rect scissor = {0, bands_top, static_cast<int>(field_size.X), bands_bottom - bands_top};
+  SDL_SetGPUScissor(render_pass, &scissor);
+
+  SDL_BindGPUGraphicsPipeline(render_pass, as->pass_pipelines[PASS_PIPELINE_FBM_WARP_FIELD]);
+  // The resolution is the frame's, which the field is evaluated over.
+  Shader_Uniforms uniforms = {};
+  uniforms.time            = static_cast<float>(render.time);
+  uniforms.resolution      = as->render_size;
+  uniforms.checkerboard    = -1.0f;
+  SDL_PushGPUFragmentUniformData(cmd_buf, 0, &uniforms, sizeof(uniforms));
+  push_warp_field_uniforms(as, cmd_buf);
+
+  SDL_DrawGPUPrimitives(render_pass, 3, 1, 0, 0);
+}
+
+// Draws the selected shader kind (or the placeholder while its pipeline is being built) into the
+// target. A checkerboard parity of 0 or 1 shades only that half of the pixels, packed into a
+// viewport half as wide; -1 shades them all.
+static void record_shader_pass(
+    App_State*            as,
+    SDL_GPUCommandBuffer* cmd_buf,
+    SDL_GPUTexture*       target,
+    int                   checkerboard_parity) {
+  // The fullscreen triangle covers the whole viewport, and nothing outside it is read.
+  SDL_GPUColorTargetInfo target_info = {};
+  target_info.texture                = target;
+  target_info.load_op                = SDL_GPU_LOADOP_DONT_CARE;
+  target_info.store_op               = SDL_GPU_STOREOP_STORE;
+  SDL_GPURenderPass* render_pass     = SDL_BeginGPURenderPass(cmd_buf, &target_info, 1, nullptr);
+  defer(SDL_EndGPURenderPass(render_pass));
+
+  SDL_GPUViewport viewport = {};
+  viewport.w               = as->render_size.X;
+  viewport.h               = as->render_size.Y;
+  viewport.max_depth       = 1.0f;
+  if (checkerboard_parity >= 0) { viewport.w = SDL_ceilf(as->render_size.X * 0.5f); }
+  SDL_SetGPUViewport(render_pass, &viewport);
+
+  auto pipeline    = as->pipelines[as->shader_kind].pipeline;
+  auto fragment_id = SHADER_KIND_RESOURCE_IDS[as->shader_kind];
+  if (pipeline == nullptr) {
+    pipeline    = as->pass_pipelines[PASS_PIPELINE_PLACEHOLDER];
+    fragment_id = PASS_RESOURCE_IDS[PASS_PIPELINE_PLACEHOLDER];
+  }
+  SDL_BindGPUGraphicsPipeline(render_pass, pipeline);
+
+  const auto& shader = resources_get(as->resources, fragment_id).shader;
+  if (shader.bindings.uniform_buffers_count > 0) {
+    Shader_Uniforms uniforms = {};
+    uniforms.time            = static_cast<float>(as->elapsed_time);
+    uniforms.resolution      = as->render_size;
+    uniforms.checkerboard    = static_cast<float>(checkerboard_parity);
+    SDL_PushGPUFragmentUniformData(cmd_buf, 0, &uniforms, sizeof(uniforms));
+  }
+  if (fragment_id == SHADER_KIND_RESOURCE_IDS[as->shader_kind] &&
+      as->shader_kind_uniforms_size > 0) {
+    SDL_PushGPUFragmentUniformData(
+        cmd_buf,
+        1,
+        as->shader_kind_uniforms.data(),
+        as->shader_kind_uniforms_size);
+  }
+  // The shader kinds that sample anything sample the noise lattice, except fbm_warp_cached.
+  if (fragment_id == RESOURCE_ID_SHADER_FRAGMENT_FBM_WARP_CACHED) {
+    const auto& frame                                    = as->warp_field_frame;
+    const auto& textures                                 = as->warp_field_cache.textures;
+    std::array<SDL_GPUTextureSamplerBinding, 2> bindings = {{
+        {textures[frame.texture0], as->linear_sampler},
+        {textures[frame.texture1], as->linear_sampler},
+    }};
+    SDL_BindGPUFragmentSamplers(render_pass, 0, bindings.data(), bindings.size());
+    push_warp_field_uniforms(as, cmd_buf);
+  } else if (shader.bindings.samplers_count > 0) {
+    const auto& noise_lattice = resources_get(as->resources, RESOURCE_ID_TEXTURE_NOISE_LATTICE);
+
+    SDL_GPUTextureSamplerBinding binding = {};
+    binding.texture                      = noise_lattice.texture.handle;
+    binding.sampler                      = as->repeat_sampler;
+    SDL_BindGPUFragmentSamplers(render_pass, 0, &binding, 1);
+  }
+
+  SDL_DrawGPUPrimitives(render_pass, 3, 1, 0, 0);
+}
+
+// Draws one of the checkerboard passes over the render_size viewport of the target.
+static void record_checkerboard_pass(
+    App_State*            as,
+    SDL_GPUCommandBuffer* cmd_buf,
+    Pass_Pipeline         pass,
+    SDL_GPUTexture*       target,
+    SDL_GPUTexture*       texture0,
+    SDL_GPUTexture*       texture1,
+    bool                  history_valid) {
+  SDL_GPUColorTargetInfo target_info = {};
+  target_info.texture                = target;
+  target_info.load_op                = SDL_GPU_LOADOP_DONT_CARE;
+  target_info.store_op               = SDL_GPU_STOREOP_STORE;
+  SDL_GPURenderPass* render_pass     = SDL_BeginGPURenderPass(cmd_buf, &target_info, 1, nullptr);
+  defer(SDL_EndGPURenderPass(render_pass));
+
+  SDL_GPUViewport viewport = {};
+  viewport.w               = as->render_size.X;
+  viewport.h               = as->render_size.Y;
+  viewport.max_depth       = 1.0f;
+  SDL_SetGPUViewport(render_pass, &viewport);
+
+  SDL_BindGPUGraphicsPipeline(render_pass, as->pass_pipelines[pass]);
+  std::array<SDL_GPUTextureSamplerBinding, 2> bindings = {{
+      {texture0, as->point_sampler},
+      {texture1, as->point_sampler},
+  }};
+  SDL_BindGPUFragmentSamplers(render_pass, 0, bindings.data(), bindings.size());
+
+  Checkerboard_Uniforms uniforms = {};
+  uniforms.texture_size          = as->window_size_pixels;
+  uniforms.render_size           = as->render_size;
+  uniforms.parity                = static_cast<float>(as->frames_count & 1);
+  uniforms.history_valid         = history_valid ? 1.0f : 0.0f;
+  SDL_PushGPUFragmentUniformData(cmd_buf, 0, &uniforms, sizeof(uniforms));
+
+  SDL_DrawGPUPrimitives(render_pass, 3, 1, 0, 0);
+}
+
+// Runs the frame prepare hook of the selected shader kind, for both of its versions.
+static void prepare_shader_kind(App_State* as) {
+  as->shader_kind_uniforms_size = 0;
+
+  auto prepare = SHADER_KIND_PREPARE_FUNCS[as->shader_kind];
+  if (prepare == nullptr) { return; }
+
+  Shader_Frame frame      = {};
+  frame.time              = static_cast<float>(as->elapsed_time);
+  frame.resolution        = as->render_size;
+  frame.ring_hearts_count = as->ring_hearts_count;
+  frame.cull_ring_hearts  = as->cull_ring_hearts;
+
+  as->shader_kind_uniforms_size = prepare(frame, as->shader_kind_uniforms.data());
+  SDL_assert(as->shader_kind_uniforms_size <= SHADER_PREPARE_MAX_UNIFORMS_SIZE);
+}
+
+static bool uses_compute_path(App_State* as) {
+  return as->compute_path && SHADER_KIND_COMPUTE_RESOURCE_IDS[as->shader_kind] != RESOURCE_ID_COUNT;
+}
+
+static const char* scene_path_name(App_State* as) {
+  return uses_compute_path(as) ? "compute" : "fragment";
+}
+
+// Runs the compute version of the selected shader kind over the render_size corner of the compute
+// target, a thread per pixel.
+static void record_compute_pass(
+    App_State*            as,
+    SDL_GPUCommandBuffer* cmd_buf,
+    Resource_ID           compute_id) {
+  SDL_GPUStorageTextureReadWriteBinding binding = {};
+  binding.texture                               = as->compute_target;
+
+  auto compute_pass = SDL_BeginGPUComputePass(cmd_buf, &binding, 1, nullptr, 0);
+  defer(SDL_EndGPUComputePass(compute_pass));
+
+  // A live reload drops the variants of the shader, which fall back to variant 0 until reloaded.
+  auto variant = resources_request_variant(
+      &as->resources,
+      &as->job_pool,
+      as->title_storage,
+      compute_id,
+      as->compute_variant_masks[as->shader_kind]);
+  if (variant == nullptr) { variant = &resources_get(as->resources, compute_id); }
+  const auto& compute = variant->compute;
+  SDL_BindGPUComputePipeline(compute_pass, compute.handle);
+  if (compute.bindings.uniform_buffers_count > 0) {
+    Shader_Uniforms uniforms = {};
+    uniforms.time            = static_cast<float>(as->elapsed_time);
+    uniforms.resolution      = as->render_size;
+    uniforms.checkerboard    = -1.0f;
+    SDL_PushGPUComputeUniformData(cmd_buf, 0, &uniforms, sizeof(uniforms));
+  }
+  if (as->shader_kind_uniforms_size > 0) {
+    SDL_PushGPUComputeUniformData(
+        cmd_buf,
+        1,
+        as->shader_kind_uniforms.data(),
+        as->shader_kind_uniforms_size);
+  }
+
+  auto width  = static_cast<Uint32>(as->render_size.X);
+  auto height = static_cast<Uint32>(as->render_size.Y);
+  SDL_DispatchGPUCompute(
+      compute_pass,
+      (width + compute.bindings.threadcount_x - 1) / compute.bindings.threadcount_x,
+      (height + compute.bindings.threadcount_y - 1) / compute.bindings.threadcount_y,
+      1);
+}
+
+// Draws the frame, with the compute version or checkerboarded if enabled for the selected shader
+// kind, and returns the texture it ends up in (at the render_size viewport).
+static SDL_GPUTexture* record_scene_passes(App_State* as, SDL_GPUCommandBuffer* cmd_buf) {
+  prepare_shader_kind(as);
+
+  if (uses_compute_path(as)) {
+    record_compute_pass(as, cmd_buf, SHADER_KIND_COMPUTE_RESOURCE_IDS[as->shader_kind]);
+    return as->compute_target;
+  }
+
+  // Sampled by every draw of fbm_warp_cached below, including both of those of Show Error. The
+  // cache adapts to the frame time dynamic resolution smooths, which leaves out the display wait
+  // (see acquire_swapchain_texture), so that it isn't pinned to the refresh interval by VSync.
+  if (uses_warp_field(as) && as->pipelines[as->shader_kind].pipeline != nullptr) {
+    const auto& dr       = as->dynamic_resolution;
+    as->warp_field_frame = warp_field_cache_update(
+        &as->warp_field_cache,
+        as->elapsed_time,
+        warp_field_size(as),
+        as->warp_field_mode_index,
+        DYNAMIC_RESOLUTION_BUDGETS_MS[dr.budget_index],
+        as->benchmarking ? 0.0f : dr.smoothed_frame_ms);
+    for (int i = 0; i < as->warp_field_frame.renders_count; i++) {
+      record_warp_field_pass(as, cmd_buf, as->warp_field_frame.renders[i]);
+    }
+  }
+
+  auto mode = as->checkerboard_modes[as->shader_kind];
+  // The placeholder doesn't checkerboard.
+  if (mode == CHECKERBOARD_MODE_OFF || as->pipelines[as->shader_kind].pipeline == nullptr) {
+    record_shader_pass(as, cmd_buf, as->render_target, -1);
+    return as->render_target;
+  }
+
+  // Reconstruction alternates between the two history textures, reading the one the previous
+  // frame wrote.
+  auto parity        = static_cast<int>(as->frames_count & 1);
+  auto history       = as->checkerboard_history[parity];
+  auto prev_history  = as->checkerboard_history[parity ^ 1];
+  bool history_valid = as->checkerboard_history_frame == as->frames_count &&
+                       as->checkerboard_history_kind == as->shader_kind &&
+                       as->checkerboard_history_size.X == as->render_size.X &&
+                       as->checkerboard_history_size.Y == as->render_size.Y;
+
+  record_shader_pass(as, cmd_buf, as->checkerboard_field, parity);
+  record_checkerboard_pass(
+      as,
+      cmd_buf,
+      PASS_PIPELINE_CHECKERBOARD_RESOLVE,
+      history,
+      as->checkerboard_field,
+      prev_history,
+      history_valid);
+  as->checkerboard_history_frame = as->frames_count + 1;
+  as->checkerboard_history_kind  = as->shader_kind;
+  as->checkerboard_history_size  = as->render_size;
+  if (mode != CHECKERBOARD_MODE_ERROR) { return history; }
+
+  // The previous history has been read by now, so it can hold the visualisation.
+  record_shader_pass(as, cmd_buf, as->render_target, -1);
+  record_checkerboard_pass(
+      as,
+      cmd_buf,
+      PASS_PIPELINE_CHECKERBOARD_ERROR,
+      prev_history,
+      history,
+      as->render_target,
+      false);
+
+  return prev_history;
+}
+
+static void push_upscale_uniforms(
+    App_State*            as,
+    SDL_GPUCommandBuffer* cmd_buf,
+    HMM_Vec2              source_size) {
+  Upscale_Uniforms uniforms = {};
+  uniforms.source_size      = source_size;
+  uniforms.texture_size     = as->window_size_pixels;
+  uniforms.output_size      = as->window_size_pixels;
+  uniforms.sharpness        = as->sharpness;
+  SDL_PushGPUFragmentUniformData(cmd_buf, 0, &uniforms, sizeof(uniforms));
+}
+
+// Upscales the render_size viewport of the source to the whole of the upscale target, flipping it
+// the right way up on the way.
+static void record_upscale_pass(
+    App_State*            as,
+    SDL_GPUCommandBuffer* cmd_buf,
+    SDL_GPUTexture*       source) {
+  SDL_GPUColorTargetInfo target_info = {};
+  target_info.texture                = as->upscale_target;
+  target_info.load_op                = SDL_GPU_LOADOP_DONT_CARE;
+  target_info.store_op               = SDL_GPU_STOREOP_STORE;
+  SDL_GPURenderPass* render_pass     = SDL_BeginGPURenderPass(cmd_buf, &target_info, 1, nullptr);
+  defer(SDL_EndGPURenderPass(render_pass));
+
+  SDL_BindGPUGraphicsPipeline(render_pass, as->pass_pipelines[PASS_PIPELINE_UPSCALE_EASU]);
+  SDL_GPUTextureSamplerBinding binding = {};
+  binding.texture                      = source;
+  binding.sampler                      = as->point_sampler;
+  SDL_BindGPUFragmentSamplers(render_pass, 0, &binding, 1);
+  push_upscale_uniforms(as, cmd_buf, as->render_size);
+
+  SDL_DrawGPUPrimitives(render_pass, 3, 1, 0, 0);
+}
+
+// Sharpens the upscale target into the render pass, which must cover the window.
+static void record_sharpen_draw(
+    App_State*            as,
+    SDL_GPUCommandBuffer* cmd_buf,
+    SDL_GPURenderPass*    render_pass) {
+  SDL_BindGPUGraphicsPipeline(render_pass, as->pass_pipelines[PASS_PIPELINE_SHARPEN_RCAS]);
+  SDL_GPUTextureSamplerBinding binding = {};
+  binding.texture                      = as->upscale_target;
+  binding.sampler                      = as->point_sampler;
+  SDL_BindGPUFragmentSamplers(render_pass, 0, &binding, 1);
+  push_upscale_uniforms(as, cmd_buf, as->window_size_pixels);
+
+  SDL_DrawGPUPrimitives(render_pass, 3, 1, 0, 0);
+}
+
+// Every shader kind is benchmarked on the fragment and then the compute path, at every render
+// scale.
+static constexpr int BENCH_PATHS_COUNT = 2;
+static constexpr int BENCH_CASES_COUNT =
+    SHADER_KIND_COUNT * BENCH_PATHS_COUNT * static_cast<int>(RENDER_TARGET_SCALE_VALUES.size());
+
+// Returns the first case from case_index on that can run, skipping the compute path of the shader
+// kinds without a compute version. BENCH_CASES_COUNT once there are none left.
+static int next_bench_case(int case_index) {
+  auto scales_count = static_cast<int>(RENDER_TARGET_SCALE_VALUES.size());
+  for (; case_index < BENCH_CASES_COUNT; case_index++) {
+    auto shader_kind = case_index / (BENCH_PATHS_COUNT * scales_count);
+    auto compute     = (case_index / scales_count) % BENCH_PATHS_COUNT == 1;
+    if (!compute || SHADER_KIND_COMPUTE_RESOURCE_IDS[shader_kind] != RESOURCE_ID_COUNT) { break; }
+  }
+
+  return case_index;
+}
+
+// Switches to the shader kind, path and render scale of the current benchmark case, and waits for
+// its variant and pipeline so that loading and building them isn't timed.
+static void begin_bench_case(App_State* as) {
+  auto scales_count      = static_cast<int>(RENDER_TARGET_SCALE_VALUES.size());
+  as->shader_kind        = as->bench.case_index / (BENCH_PATHS_COUNT * scales_count);
+  as->compute_path       = (as->bench.case_index / scales_count) % BENCH_PATHS_COUNT == 1;
+  as->render_scale_index = as->bench.case_index % scales_count;
+  update_render_size(as);
+
+  // The variant is loaded before the pipeline is built from it.
+  update_pipelines(as);
+  while (!picked_variant_settled(as)) {
+    job_pool_wait(&as->job_pool);
+    update_pipelines(as);
+  }
+}
+
+// Logs a summary of the frame times recorded in headless mode, and each frame at debug priority.
+static void report_frame_times(App_State* as) {
+  const auto& times = as->frame_times_ms;
+  if (times.empty()) { return; }
+
+  // Includes waiting for the GPU to finish the last frame, so that the frame rate reflects GPU
+  // throughput rather than how far ahead the CPU got.
+  SDL_WaitForGPUIdle(as->device);
+  auto total_seconds = static_cast<double>(SDL_GetPerformanceCounter() - as->first_frame_counter) /
+                       static_cast<double>(as->count_per_second);
+
+  float  min_ms = times[0];
+  float  max_ms = times[0];
+  double sum_ms = 0.0;
+  for (size_t i = 0; i < times.size(); i++) {
+    SDL_LogDebug(SDL_LOG_CATEGORY_APPLICATION, "Frame %d: %.3f ms", static_cast<int>(i), times[i]);
+    min_ms = SDL_min(min_ms, times[i]);
+    max_ms = SDL_max(max_ms, times[i]);
+    sum_ms += times[i];
+  }
+
+  SDL_LogInfo(
+      SDL_LOG_CATEGORY_APPLICATION,
+      "%s (%s) at %dx%d: %d frames, %.3f ms avg, %.3f ms min, %.3f ms max, %.1f FPS",
+      RESOURCES_INFO[SHADER_KIND_RESOURCE_IDS[as->shader_kind]].file_name,
+      scene_path_name(as),
+      static_cast<int>(as->render_size.X),
+      static_cast<int>(as->render_size.Y),
+      static_cast<int>(as->frames_count),
+      sum_ms / static_cast<double>(times.size()),
+      min_ms,
+      max_ms,
+      static_cast<double>(as->frames_count) / SDL_max(total_seconds, 1e-9));
+}
+
+// Whether dynamic resolution or the warp field cache adapt to the frame time.
+static bool adapts_to_frame_time(App_State* as) {
+  auto warp_field_cached = uses_warp_field(as) && as->warp_field_cache.enabled;
+  return !as->benchmarking && (as->dynamic_resolution.enabled || warp_field_cached);
+}
+
+// When something adapts to the frame time, first waits for the GPU to finish the last frame, so
+// that the swapchain wait that follows is only for the display and can be left out of the frame
+// time. Waiting for the last frame rather than the one before costs some overlap of the CPU and
+// GPU, so it is only done then.
+static bool acquire_swapchain_texture(
+    App_State*            as,
+    SDL_GPUCommandBuffer* cmd_buf,
+    SDL_GPUTexture**      out_texture) {
+  auto measure = adapts_to_frame_time(as);
+  if (measure) { gpu_release_queue_wait_last_frame(&as->release_queue, as->device); }
+  auto wait_start = SDL_GetPerformanceCounter();
+  if (!SDL_WaitAndAcquireGPUSwapchainTexture(cmd_buf, as->window, out_texture, nullptr, nullptr)) {
+    return false;
+  }
+  as->present_wait_counter = measure ? SDL_GetPerformanceCounter() - wait_start : 0;
+
+  return true;
+}
+
 SDL_AppResult SDL_AppIterate(void* appstate) {
   auto as = static_cast<App_State*>(appstate);
+  defer(arena_reset(&as->frame_arena));
+  defer(alloc_tracker_set_phase(ALLOC_PHASE_NONE));
+
+  auto frame_start_counter = SDL_GetPerformanceCounter();
+  if (as->benchmarking && as->bench.case_frame == 0) { begin_bench_case(as); }
+
+  alloc_tracker_set_phase(ALLOC_PHASE_UPDATE);
+  gpu_release_queue_collect(&as->release_queue, as->device);
 
 #ifdef BUILD_DEBUG
-  std::array<Resource_ID, RESOURCE_ID_COUNT> modified_resource_ids;
-  int                                        modified_resource_ids_count;
-  resources_live_reload(
-      &as->resources,
-      as->device,
-      as->title_storage,
-      &modified_resource_ids,
-      &modified_resource_ids_count);
+  // Reloading releases the replaced shaders, which in flight pipeline jobs may still be reading.
+  if (!pipelines_pending(as)) {
+    alloc_tracker_set_phase(ALLOC_PHASE_LIVE_RELOAD);
+    defer(alloc_tracker_set_phase(ALLOC_PHASE_UPDATE));
+
+    Resource_ID* modified_resource_ids;
+    int          modified_resource_ids_count;
+    resources_live_reload(
+        &as->resources,
+        as->device,
+        as->title_storage,
+        &as->job_pool,
+        &as->release_queue,
+        &as->frame_arena,
+        &modified_resource_ids,
+        &modified_resource_ids_count);
+
+    // Gather the whole batch first, so that a pipeline is rebuilt once however many of its
+    // shaders changed.
+    auto rebuild = arena_push_array<bool>(&as->frame_arena, PIPELINE_COUNT);
+    for (int i = 0; i < modified_resource_ids_count; i++) {
+      const auto& dependents = RESOURCE_PIPELINE_DEPENDENTS[modified_resource_ids[i]];
+      for (int j = 0; j < PIPELINE_COUNT; j++) { rebuild[j] = rebuild[j] || dependents[j]; }
+    }
 
-  for (auto id : modified_resource_ids) {
-    switch (id) {
-    case RESOURCE_ID_SHADER_VERTEX_FULLSCREEN: {
-      for (int i = 0; i < SHADER_KIND_COUNT; i++) {
-        init_pipeline(as, static_cast<Shader_Kind>(i));
-      }
-    } break;
-    case RESOURCE_ID_SHADER_FRAGMENT_FBM_WARP: {
-      init_pipeline(as, SHADER_KIND_FBM_WARP);
-    } break;
-    case RESOURCE_ID_SHADER_FRAGMENT_PLASMA_BEAT: {
-      init_pipeline(as, SHADER_KIND_PLASMA_BEAT);
-    } break;
-    default:
-      break;
+    for (int i = 0; i < PASS_PIPELINE_COUNT; i++) {
+      if (rebuild[SHADER_KIND_COUNT + i]) { init_pass_pipeline(as, static_cast<Pass_Pipeline>(i)); }
+    }
+    if (rebuild[SHADER_KIND_COUNT + PASS_PIPELINE_FBM_WARP_FIELD]) {
+      warp_field_cache_invalidate(&as->warp_field_cache);
+    }
+    for (int i = 0; i < SHADER_KIND_COUNT; i++) {
+      if (rebuild[i]) { invalidate_pipeline(as, i); }
     }
   }
 #endif
+  update_pipelines(as);
+
+  if (as->checkerboard_modes[as->shader_kind] != CHECKERBOARD_MODE_OFF &&
+      as->checkerboard_field == nullptr && !init_checkerboard_textures(as)) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create checkerboard textures");
+    return SDL_APP_FAILURE;
+  }
+  if (as->compute_path && as->compute_target == nullptr && !init_compute_target(as)) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create compute target");
+    return SDL_APP_FAILURE;
+  }
+  const auto& warp_field_textures = as->warp_field_cache.textures;
+  if (uses_warp_field(as) &&
+      (warp_field_textures[0] == nullptr ||
+       (as->warp_field_cache.enabled && warp_field_textures[1] == nullptr)) &&
+      !init_warp_field(as)) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create warp field");
+    return SDL_APP_FAILURE;
+  }
 
   auto counter       = SDL_GetPerformanceCounter();
   auto counter_delta = counter - as->last_counter;
   as->last_counter   = counter;
+  if (as->headless && !as->benchmarking) {
+    if (as->frames_count == 0) {
+      as->first_frame_counter = counter;
+    } else if (as->frame_times_ms.size() < as->frame_times_ms.capacity()) {
+      as->frame_times_ms.push_back(
+          static_cast<float>(counter_delta * 1000.0 / static_cast<double>(as->count_per_second)));
+    }
+  }
+  // Dynamic resolution gets the unclamped interval, so that an overloaded frame still counts, less
+  // the time the last frame waited for the display.
+  auto work_counter  = counter_delta - SDL_min(as->present_wait_counter, counter_delta);
+  auto frame_seconds = static_cast<double>(work_counter) /
+                       static_cast<double>(as->count_per_second);
   if (counter_delta > as->max_counter_delta) { counter_delta = as->count_per_second / 60; }
 
   auto delta_time = static_cast<double>(counter_delta) / static_cast<double>(as->count_per_second);
@@ -430,13 +1931,24 @@ SDL_AppResult SDL_AppIterate(void* appstate) {
 
   static constexpr double TIME_RESET_PERIOD = 3600.0;
   if (as->elapsed_time >= TIME_RESET_PERIOD) { as->elapsed_time = 0.0; }
+  // Every benchmark case sees the same sequence of shader times, whatever the frame rate.
+  if (as->benchmarking) { as->elapsed_time = as->bench.case_frame * BENCH_TIME_STEP; }
+
+  if (!as->benchmarking) {
+    dynamic_resolution_update(&as->dynamic_resolution, frame_seconds);
+    update_render_size(as);
+  }
 
-  ImGui_ImplSDLGPU3_NewFrame();
-  ImGui_ImplSDL3_NewFrame();
-  ImGui::NewFrame();
-  draw_imgui(as);
-  ImGui::Render();
+  if (!as->headless) {
+    alloc_tracker_set_phase(ALLOC_PHASE_IMGUI_BUILD);
+    ImGui_ImplSDLGPU3_NewFrame();
+    ImGui_ImplSDL3_NewFrame();
+    ImGui::NewFrame();
+    draw_imgui(as);
+    ImGui::Render();
+  }
 
+  alloc_tracker_set_phase(ALLOC_PHASE_COMMAND_RECORDING);
   SDL_GPUCommandBuffer* cmd_buf = SDL_AcquireGPUCommandBuffer(as->device);
   if (cmd_buf == nullptr) {
     SDL_LogError(
@@ -446,13 +1958,8 @@ SDL_AppResult SDL_AppIterate(void* appstate) {
     return SDL_APP_FAILURE;
   }
 
-  SDL_GPUTexture* swapchain_texture;
-  if (!SDL_WaitAndAcquireGPUSwapchainTexture(
-          cmd_buf,
-          as->window,
-          &swapchain_texture,
-          nullptr,
-          nullptr)) {
+  SDL_GPUTexture* swapchain_texture = nullptr;
+  if (!as->headless && !acquire_swapchain_texture(as, cmd_buf, &swapchain_texture)) {
     SDL_LogError(
         SDL_LOG_CATEGORY_APPLICATION,
         "Failed to acquire swapchain texture: %s",
@@ -460,38 +1967,20 @@ SDL_AppResult SDL_AppIterate(void* appstate) {
     return SDL_APP_FAILURE;
   }
 
-  if (swapchain_texture != nullptr && !as->window_minimized) {
+  if (as->headless) {
+    record_scene_passes(as, cmd_buf);
+  } else if (swapchain_texture != nullptr && !as->window_minimized) {
     ImDrawData* draw_data = ImGui::GetDrawData();
     ImGui_ImplSDLGPU3_PrepareDrawData(draw_data, cmd_buf);
 
-    {
-      SDL_GPUColorTargetInfo target_info = {};
-      target_info.texture                = as->render_target;
-      target_info.load_op                = SDL_GPU_LOADOP_CLEAR;
-      target_info.store_op               = SDL_GPU_STOREOP_STORE;
-      SDL_GPURenderPass* render_pass = SDL_BeginGPURenderPass(cmd_buf, &target_info, 1, nullptr);
-      defer(SDL_EndGPURenderPass(render_pass));
+    auto scene_texture = record_scene_passes(as, cmd_buf);
 
-      SDL_BindGPUGraphicsPipeline(render_pass, as->pipelines[as->shader_kind]);
-
-      switch (as->shader_kind) {
-      case SHADER_KIND_FBM_WARP:
-      case SHADER_KIND_PLASMA_BEAT: {
-        Shader_FBM_Warp_Uniforms uniforms = {};
-        uniforms.time                     = static_cast<float>(as->elapsed_time);
-        uniforms.resolution               = as->render_size;
-        SDL_PushGPUFragmentUniformData(cmd_buf, 0, &uniforms, sizeof(uniforms));
-      } break;
-      default:
-        break;
-      }
-
-      SDL_DrawGPUPrimitives(render_pass, 3, 1, 0, 0);
-    }
-
-    {
+    bool upscale = as->upscaler == UPSCALER_EASU_RCAS;
+    if (upscale) {
+      record_upscale_pass(as, cmd_buf, scene_texture);
+    } else {
       SDL_GPUBlitInfo info     = {};
-      info.source.texture      = as->render_target;
+      info.source.texture      = scene_texture;
       info.source.w            = static_cast<int>(as->render_size.X);
       info.source.h            = static_cast<int>(as->render_size.Y);
       info.destination.texture = swapchain_texture;
@@ -504,35 +1993,136 @@ SDL_AppResult SDL_AppIterate(void* appstate) {
     }
 
     {
+      // The sharpen pass covers the whole window, the blit has to be kept.
       SDL_GPUColorTargetInfo target_info = {};
       target_info.texture                = swapchain_texture;
-      target_info.load_op                = SDL_GPU_LOADOP_DONT_CARE;
+      target_info.load_op                = upscale ? SDL_GPU_LOADOP_DONT_CARE : SDL_GPU_LOADOP_LOAD;
       target_info.store_op               = SDL_GPU_STOREOP_STORE;
       SDL_GPURenderPass* render_pass = SDL_BeginGPURenderPass(cmd_buf, &target_info, 1, nullptr);
       defer(SDL_EndGPURenderPass(render_pass));
 
+      if (upscale) { record_sharpen_draw(as, cmd_buf, render_pass); }
       ImGui_ImplSDLGPU3_RenderDrawData(draw_data, cmd_buf, render_pass);
     }
   }
 
-  SDL_SubmitGPUCommandBuffer(cmd_buf);
+  alloc_tracker_set_phase(ALLOC_PHASE_SUBMIT);
+  auto fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmd_buf);
+  if (fence == nullptr) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to submit command buffer: %s",
+        SDL_GetError());
+  }
+  if (as->benchmarking) {
+    // Waiting for every frame keeps the GPU queue empty at each submit, so the time until the
+    // fence signals is the GPU time of this frame alone (plus the driver's submission latency).
+    auto submit_counter = SDL_GetPerformanceCounter();
+    if (fence != nullptr) { SDL_WaitForGPUFences(as->device, true, &fence, 1); }
+    auto ms_per_count = 1000.0 / static_cast<double>(as->count_per_second);
+    if (bench_is_measuring(as->bench)) {
+      bench_add_sample(
+          &as->bench,
+          static_cast<float>((submit_counter - frame_start_counter) * ms_per_count),
+          static_cast<float>((SDL_GetPerformanceCounter() - submit_counter) * ms_per_count));
+    }
+  }
+  gpu_release_queue_end_frame(&as->release_queue, as->device, fence);
+  alloc_tracker_set_phase(ALLOC_PHASE_NONE);
+
+  as->alloc_stats    = alloc_tracker_take_stats();
+  auto warmup_frames = static_cast<uint64_t>(as->alloc_check_warmup_frames);
+  if (as->alloc_check_warmup_frames >= 0 && as->frames_count >= warmup_frames) {
+    if (alloc_stats_total_count(as->alloc_stats) > 0) {
+      SDL_LogError(
+          SDL_LOG_CATEGORY_APPLICATION,
+          "Alloc check failed: frame %" SDL_PRIu64 " allocated after warming up",
+          as->frames_count);
+      for (int i = 0; i < ALLOC_PHASE_COUNT; i++) {
+        if (as->alloc_stats.counts[i] == 0) { continue; }
+        SDL_LogError(
+            SDL_LOG_CATEGORY_APPLICATION,
+            "  %s: %" SDL_PRIu64 " allocations, %" SDL_PRIu64 " bytes",
+            ALLOC_PHASE_NAMES[i],
+            as->alloc_stats.counts[i],
+            as->alloc_stats.bytes[i]);
+      }
+      return SDL_APP_FAILURE;
+    }
+    if (as->frames_count + 1 >= warmup_frames + ALLOC_CHECK_FRAMES_COUNT) {
+      SDL_LogInfo(
+          SDL_LOG_CATEGORY_APPLICATION,
+          "Alloc check passed: no allocations in %" SDL_PRIu64 " frames",
+          ALLOC_CHECK_FRAMES_COUNT);
+      return SDL_APP_SUCCESS;
+    }
+  }
+
+  if (as->frames_count == 0) {
+    SDL_LogInfo(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "First frame submitted %llu ms after startup",
+        static_cast<unsigned long long>(SDL_GetTicks()));
+  }
+  as->frames_count += 1;
+
+  if (as->frames_limit > 0 && as->frames_count >= as->frames_limit) { return SDL_APP_SUCCESS; }
+
+  if (as->benchmarking && bench_end_frame(&as->bench)) {
+    bench_end_case(
+        &as->bench,
+        RESOURCES_INFO[SHADER_KIND_RESOURCE_IDS[as->shader_kind]].file_name,
+        scene_path_name(as),
+        RENDER_TARGET_SCALE_VALUES[as->render_scale_index],
+        static_cast<int>(as->render_size.X),
+        static_cast<int>(as->render_size.Y));
+    as->bench.case_index = next_bench_case(as->bench.case_index);
+    if (as->bench.case_index == BENCH_CASES_COUNT) {
+      auto driver_name = SDL_GetGPUDeviceDriver(as->device);
+      return bench_write_report(as->bench, driver_name) ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+    }
+  }
 
   return SDL_APP_CONTINUE;
 }
 
 void SDL_AppQuit(void* appstate, SDL_AppResult result) {
   auto as = static_cast<App_State*>(appstate);
+  if (as == nullptr) {
+    SDL_Quit();
+    return;
+  }
 
+  if (as->headless) { report_frame_times(as); }
   SDL_WaitForGPUIdle(as->device);
 
+  job_pool_destroy(&as->job_pool);
+  for (auto& slot : as->pipelines) {
+    SDL_ReleaseGPUGraphicsPipeline(as->device, slot.pipeline);
+    SDL_ReleaseGPUGraphicsPipeline(as->device, slot.created);
+  }
+  for (auto pipeline : as->pass_pipelines) { SDL_ReleaseGPUGraphicsPipeline(as->device, pipeline); }
+  SDL_ReleaseGPUSampler(as->device, as->point_sampler);
+  SDL_ReleaseGPUSampler(as->device, as->repeat_sampler);
+  SDL_ReleaseGPUSampler(as->device, as->linear_sampler);
+  SDL_ReleaseGPUTexture(as->device, as->render_target);
+  SDL_ReleaseGPUTexture(as->device, as->upscale_target);
+  SDL_ReleaseGPUTexture(as->device, as->checkerboard_field);
+  for (auto texture : as->checkerboard_history) { SDL_ReleaseGPUTexture(as->device, texture); }
+  SDL_ReleaseGPUTexture(as->device, as->compute_target);
+  warp_field_cache_destroy(&as->warp_field_cache, as->device);
+  gpu_release_queue_destroy(&as->release_queue, as->device);
   resources_destroy(&as->resources, as->device);
+  arena_destroy(&as->frame_arena);
 
-  ImGui_ImplSDL3_Shutdown();
-  ImGui_ImplSDLGPU3_Shutdown();
-  ImGui::DestroyContext();
+  if (!as->headless) {
+    ImGui_ImplSDL3_Shutdown();
+    ImGui_ImplSDLGPU3_Shutdown();
+    ImGui::DestroyContext();
 
-  SDL_ReleaseWindowFromGPUDevice(as->device, as->window);
-  SDL_DestroyWindow(as->window);
+    SDL_ReleaseWindowFromGPUDevice(as->device, as->window);
+    SDL_DestroyWindow(as->window);
+  }
   SDL_DestroyGPUDevice(as->device);
 
   SDL_CloseStorage(as->title_storage);
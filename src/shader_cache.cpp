@@ -0,0 +1,162 @@
+// -- Shader Cache ------------------------------------------------------------
+//
+// Content addressed on-disk cache of compiled shader bytecode, stored in user storage. Entries are
+// keyed by a hash of everything that affects the compiler output, so a file that is touched but
+// not changed (or changed and then reverted) never hits DXC again. Each entry can also hold a small
+// fixed size metadata blob (e.g. reflection results) that is stored in front of the bytecode.
+
+static constexpr const char* SHADER_CACHE_DIR     = "shader_cache";
+static constexpr uint32_t    SHADER_CACHE_MAGIC   = 0x48534453;  // "SDSH"
+static constexpr uint32_t    SHADER_CACHE_VERSION = 3;
+
+struct Shader_Cache_Key {
+  const char*                 source;
+  size_t                      source_size;
+  const char*                 entrypoint;
+  const char*                 defines;
+  SDL_ShaderCross_ShaderStage stage;
+  SDL_GPUShaderFormat         format;
+};
+
+struct Shader_Cache_Entry_Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t metadata_size;
+  uint32_t code_size;
+  uint64_t key;
+};
+
+struct Shader_Cache {
+  SDL_Storage*  storage;
+  SDL_AtomicInt hits;
+  SDL_AtomicInt misses;
+  SDL_AtomicInt compile_time_ms;
+};
+
+static uint64_t shader_cache_key_hash(const Shader_Cache_Key& key) {
+  uint64_t hash = hash_bytes(key.source, key.source_size);
+  hash          = hash_string(key.entrypoint, hash);
+  hash          = hash_string(key.defines, hash);
+  hash          = hash_bytes(&key.stage, sizeof(key.stage), hash);
+  hash          = hash_bytes(&key.format, sizeof(key.format), hash);
+
+  return hash;
+}
+
+static void shader_cache_entry_path(uint64_t key, char* out_path, size_t out_path_size) {
+  SDL_snprintf(
+      out_path,
+      out_path_size,
+      "%s/%016llx.bin",
+      SHADER_CACHE_DIR,
+      static_cast<unsigned long long>(key));
+}
+
+static bool shader_cache_init(Shader_Cache* cache) {
+  SDL_assert(cache != nullptr);
+
+  cache->storage = SDL_OpenUserStorage("adelciotto", "sdl3_gpu_shaders_cross_compile", 0);
+  if (cache->storage == nullptr) {
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to open user storage: %s", SDL_GetError());
+    return false;
+  }
+  while (!SDL_StorageReady(cache->storage)) { SDL_Delay(1); }
+
+  SDL_PathInfo path_info;
+  if (!SDL_GetStoragePathInfo(cache->storage, SHADER_CACHE_DIR, &path_info) &&
+      !SDL_CreateStorageDirectory(cache->storage, SHADER_CACHE_DIR)) {
+    SDL_LogError(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to create shader cache directory: %s",
+        SDL_GetError());
+    return false;
+  }
+
+  return true;
+}
+
+// Safe to call from any thread. The entry is read into the arena and the returned code points
+// straight into it.
+static bool shader_cache_read(
+    Shader_Cache* cache,
+    Arena*        arena,
+    uint64_t      key,
+    void*         out_metadata,
+    size_t        metadata_size,
+    Byte_Span*    out_code) {
+  SDL_assert(cache != nullptr);
+  SDL_assert(arena != nullptr);
+  SDL_assert(out_metadata != nullptr || metadata_size == 0);
+  SDL_assert(out_code != nullptr);
+
+  char path[64];
+  shader_cache_entry_path(key, path, sizeof(path));
+
+  Uint64 file_size = 0;
+  if (!SDL_GetStorageFileSize(cache->storage, path, &file_size)) { return false; }
+  if (file_size <= sizeof(Shader_Cache_Entry_Header) + metadata_size) { return false; }
+
+  Byte_Span contents;
+  if (!read_storage_file(cache->storage, path, arena, &contents)) { return false; }
+
+  Shader_Cache_Entry_Header header;
+  SDL_memcpy(&header, contents.data, sizeof(header));
+  if (header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_CACHE_VERSION) {
+    return false;
+  }
+  if (header.key != key || header.metadata_size != metadata_size ||
+      header.code_size != contents.size - sizeof(header) - metadata_size) {
+    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Ignoring corrupt shader cache entry %s", path);
+    return false;
+  }
+
+  SDL_memcpy(out_metadata, contents.data + sizeof(header), metadata_size);
+  out_code->data = contents.data + sizeof(header) + metadata_size;
+  out_code->size = header.code_size;
+
+  return true;
+}
+
+// Safe to call from any thread. The entry is assembled in the arena.
+static void shader_cache_write(
+    Shader_Cache* cache,
+    Arena*        arena,
+    uint64_t      key,
+    const void*   metadata,
+    size_t        metadata_size,
+    Byte_Span     code) {
+  SDL_assert(cache != nullptr);
+  SDL_assert(arena != nullptr);
+  SDL_assert(metadata != nullptr || metadata_size == 0);
+
+  char path[64];
+  shader_cache_entry_path(key, path, sizeof(path));
+
+  Shader_Cache_Entry_Header header = {};
+  header.magic                     = SHADER_CACHE_MAGIC;
+  header.version                   = SHADER_CACHE_VERSION;
+  header.metadata_size             = static_cast<uint32_t>(metadata_size);
+  header.code_size                 = static_cast<uint32_t>(code.size);
+  header.key                       = key;
+
+  auto contents_size = sizeof(header) + metadata_size + code.size;
+  auto contents      = static_cast<uint8_t*>(arena_push(arena, contents_size));
+  if (contents == nullptr) { return; }
+  SDL_memcpy(contents, &header, sizeof(header));
+  SDL_memcpy(contents + sizeof(header), metadata, metadata_size);
+  SDL_memcpy(contents + sizeof(header) + metadata_size, code.data, code.size);
+  if (!SDL_WriteStorageFile(cache->storage, path, contents, contents_size)) {
+    SDL_LogWarn(
+        SDL_LOG_CATEGORY_APPLICATION,
+        "Failed to write shader cache entry %s: %s",
+        path,
+        SDL_GetError());
+  }
+}
+
+static void shader_cache_destroy(Shader_Cache* cache) {
+  SDL_assert(cache != nullptr);
+
+  SDL_CloseStorage(cache->storage);
+  cache->storage = nullptr;
+}
@@ -0,0 +1,117 @@
+// -- Shader Frame Prepare ----------------------------------------------------
+//
+// Per shader kind hooks that compute what is the same for every pixel of a frame once on the CPU,
+// rather than in every invocation of the shader. A hook fills the uniform block of its shader kind
+// (slot 1, after the Uniform_Block of common.hlsl), which is pushed to both its fragment and its
+// compute version. Shader kinds are matched to their hook by file name.
+
+static constexpr size_t SHADER_PREPARE_MAX_UNIFORMS_SIZE = 4096;
+
+// What a hook gets to go on: the same as the Uniform_Block of common.hlsl, followed by the quality
+// settings of the shader kinds.
+struct Shader_Frame {
+  float    time;
+  HMM_Vec2 resolution;
+
+  int  ring_hearts_count;  // Of plasma_beat, up to PLASMA_BEAT_RING_HEARTS_MAX_COUNT.
+  bool cull_ring_hearts;
+};
+
+// Writes the uniform block into uniforms, which holds SHADER_PREPARE_MAX_UNIFORMS_SIZE bytes, and
+// returns its size.
+typedef uint32_t (*Shader_Prepare_Func)(const Shader_Frame& frame, void* uniforms);
+
+struct Shader_Prepare_Hook {
+  const char*         name;  // Of the fragment shader.
+  Shader_Prepare_Func prepare;
+};
+
+// Matches RING_HEARTS_MAX_COUNT and RING_HEART_SIZE in plasma_beat_common.hlsl.
+static constexpr int   PLASMA_BEAT_RING_HEARTS_MAX_COUNT     = 64;
+static constexpr int   PLASMA_BEAT_RING_HEARTS_DEFAULT_COUNT = 12;
+static constexpr float PLASMA_BEAT_RING_HEART_SIZE           = 0.08f;
+
+// A heart covers the points within 0.770 of its centre, in the units of heart() (measured), with
+// the units 1.6 times its size. The radius of the ring is this, give or take the ring pulse.
+static constexpr float PLASMA_BEAT_RING_HEART_EXTENT = 0.78f;
+static constexpr float PLASMA_BEAT_RING_RADIUS       = 0.65f;
+
+// Bounds that contain the whole screen, for when the hearts aren't culled.
+static constexpr float PLASMA_BEAT_UNCULLED_BOUNDS_RADIUS = 1e6f;
+
+// Matches the Plasma_Beat_Uniforms in plasma_beat_common.hlsl.
+struct Plasma_Beat_Uniforms {
+  HMM_Vec2 plasma_cos_sin;
+  float    pulse_phase;
+  float    centre_pulse_amplitude;
+  float    ring_pulse_amplitude;
+  uint32_t ring_hearts_count;
+  float    ring_heart_bounds_radius;
+  float    padding;
+
+  // Cos and sin of the angle, followed by the centre of the bounds.
+  std::array<HMM_Vec4, PLASMA_BEAT_RING_HEARTS_MAX_COUNT> ring_hearts;
+  std::array<HMM_Vec4, PLASMA_BEAT_RING_HEARTS_MAX_COUNT> ring_heart_colors;
+};
+static_assert(sizeof(Plasma_Beat_Uniforms) <= SHADER_PREPARE_MAX_UNIFORMS_SIZE);
+
+// mod in common.hlsl, which unlike fmod rounds towards negative infinity.
+static float shader_mod(float x, float y) {
+  return x - y * SDL_floorf(x / y);
+}
+
+// Function from Iñigo Quiles (no cubic smoothing)
+// https://www.shadertoy.com/view/MsS3Wc
+static HMM_Vec3 shader_hsv_to_rgb(HMM_Vec3 c) {
+  static constexpr std::array<float, 3> offsets = {0.0f, 4.0f, 2.0f};
+
+  HMM_Vec3 rgb;
+  for (int i = 0; i < 3; i++) {
+    auto v          = SDL_fabsf(shader_mod(c.X * 6.0f + offsets[i], 6.0f) - 3.0f) - 1.0f;
+    rgb.Elements[i] = SDL_clamp(v, 0.0f, 1.0f);
+  }
+  return HMM_MulV3F(HMM_LerpV3(HMM_V3(1.0f, 1.0f, 1.0f), c.Y, rgb), c.Z);
+}
+
+// The plasma rotation, the parts of the pulses that don't depend on the pixel, and the angle,
+// colour and bounding circle of every heart of the ring. The hearts are spread evenly around the
+// ring. Each bounding circle contains every pixel its heart can cover, wherever the ring pulse puts
+// it, so that the shaders only evaluate the hearts whose bounds contain (or overlap the tile of) a
+// pixel.
+static uint32_t plasma_beat_prepare(const Shader_Frame& frame, void* uniforms) {
+  static constexpr float PULSE_DURATION = 1.5f;
+
+  auto time       = frame.time;
+  auto pulse_time = shader_mod(time, PULSE_DURATION) / PULSE_DURATION;
+  auto pulse_beat = SDL_powf(pulse_time, 0.2f) * 0.5f + 0.5f;
+
+  Plasma_Beat_Uniforms u   = {};
+  u.plasma_cos_sin         = HMM_V2(SDL_cosf(time * 0.3f), SDL_sinf(time * 0.3f));
+  u.pulse_phase            = pulse_time * HMM_PI32 * 2.0f * 3.0f;
+  u.centre_pulse_amplitude = pulse_beat * 0.5f * SDL_expf(-pulse_time * 4.0f);
+  u.ring_pulse_amplitude   = pulse_beat * 0.3f * SDL_expf(-pulse_time * 3.33f);
+
+  auto hearts_count = SDL_clamp(frame.ring_hearts_count, 1, PLASMA_BEAT_RING_HEARTS_MAX_COUNT);
+  auto heart_radius = 1.6f * PLASMA_BEAT_RING_HEART_SIZE * PLASMA_BEAT_RING_HEART_EXTENT;
+  auto spacing      = HMM_PI32 * 2.0f / static_cast<float>(hearts_count);
+
+  u.ring_hearts_count        = static_cast<uint32_t>(hearts_count);
+  u.ring_heart_bounds_radius = frame.cull_ring_hearts ? heart_radius + u.ring_pulse_amplitude
+                                                      : PLASMA_BEAT_UNCULLED_BOUNDS_RADIUS;
+  for (int i = 0; i < hearts_count; i++) {
+    auto angle   = time * 0.8f + static_cast<float>(i + 1) * spacing;
+    auto hue     = angle / (HMM_PI32 * 2.0f) + 0.5f;
+    auto cos_sin = HMM_V2(SDL_cosf(angle), SDL_sinf(angle));
+    auto centre  = HMM_MulV2F(cos_sin, PLASMA_BEAT_RING_RADIUS);
+
+    u.ring_hearts[i]       = HMM_V4(cos_sin.X, cos_sin.Y, centre.X, centre.Y);
+    u.ring_heart_colors[i] = HMM_V4V(shader_hsv_to_rgb(HMM_V3(hue, 1.0f, 1.0f)), 1.0f);
+  }
+
+  SDL_memcpy(uniforms, &u, sizeof(u));
+  return sizeof(u);
+}
+
+static constexpr std::array<Shader_Prepare_Hook, 1> SHADER_PREPARE_HOOKS = {{
+    {"plasma_beat", plasma_beat_prepare},
+}};
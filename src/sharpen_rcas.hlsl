@@ -0,0 +1,35 @@
+// Robust contrast adaptive sharpening, after the RCAS pass of AMD FidelityFX Super Resolution 1.0
+// (MIT licensed). Sharpens with a 5 tap cross whose negative lobe is limited per pixel so that the
+// result never leaves the range of its neighbours, which keeps it from ringing or clipping.
+
+#include "upscale_common.hlsl"
+
+// Limits the lobe so the filter stays stable (the sum of weights can't reach zero).
+static const float RCAS_LIMIT = 0.25 - 1.0 / 16.0;
+
+float4 main(float2 tex_coord : TEXCOORD0) : SV_Target {
+  int2 p = int2(tex_coord * output_size);
+
+  //   b
+  // d e f
+  //   h
+  float3 b = load_source(p + int2(0, -1));
+  float3 d = load_source(p + int2(-1, 0));
+  float3 e = load_source(p);
+  float3 f = load_source(p + int2(1, 0));
+  float3 h = load_source(p + int2(0, 1));
+
+  float3 min4 = min(min(b, d), min(f, h));
+  float3 max4 = max(max(b, d), max(f, h));
+
+  // The largest negative lobe that keeps every channel within [0, 1] given its neighbours.
+  float3 hit_min  = min4 / max(4.0 * max4, 1e-5);
+  float3 hit_max  = (1.0 - max4) / min(4.0 * min4 - 4.0, -1e-5);
+  float3 lobe_rgb = max(-hit_min, hit_max);
+  float  lobe_max = max(lobe_rgb.r, max(lobe_rgb.g, lobe_rgb.b));
+  float  lobe     = max(-RCAS_LIMIT, min(lobe_max, 0.0)) * exp2(-sharpness);
+
+  float3 color = (lobe * (b + d + f + h) + e) / (4.0 * lobe + 1.0);
+
+  return float4(color, 1.0);
+}
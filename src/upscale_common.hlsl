@@ -0,0 +1,24 @@
+#pragma once
+
+// Shared by the upscaler passes, which read a region in the top left corner of a texture that may
+// be larger than it.
+cbuffer Upscale_Uniforms : register(b0, space3) {
+  float2 source_size : packoffset(c0);     // Of the region read.
+  float2 texture_size : packoffset(c0.z);  // Of the whole texture.
+  float2 output_size : packoffset(c1);
+  float  sharpness : packoffset(c1.z);     // In stops, 0 is the sharpest.
+};
+
+Texture2D<float4> source_texture : register(t0, space2);
+SamplerState      source_sampler : register(s0, space2);
+
+// Fetches a pixel of the region, clamping to its edges. Expects a point sampler.
+float3 load_source(int2 p) {
+  p         = clamp(p, int2(0, 0), int2(source_size) - 1);
+  float2 uv = (float2(p) + 0.5) / texture_size;
+  return source_texture.SampleLevel(source_sampler, uv, 0.0).rgb;
+}
+
+float upscale_luma(float3 c) {
+  return c.g + 0.5 * (c.r + c.b);
+}
@@ -0,0 +1,143 @@
+// Edge adaptive spatial upscaler, after the EASU pass of AMD FidelityFX Super Resolution 1.0 (MIT
+// licensed). Each output pixel is a 12 tap, Lanczos-2 like filter of the input whose kernel is
+// rotated along the local gradient and stretched along edges, then clamped to the 2x2 texels
+// nearest to it to avoid ringing. Written for fp32, one pixel per invocation.
+//
+// The shader kinds render upside down (their y axis points up), so the input is flipped here.
+
+#include "upscale_common.hlsl"
+
+// Accumulates the gradient direction and edge length of one of the four bilinear quadrants around
+// the output position, weighted by its bilinear weight. The luma taps form a plus shape:
+//   a
+// b c d
+//   e
+void easu_set(
+    inout float2 dir,
+    inout float  len,
+    float        w,
+    float        la,
+    float        lb,
+    float        lc,
+    float        ld,
+    float        le) {
+  float dc    = ld - lc;
+  float cb    = lc - lb;
+  float len_x = max(abs(dc), abs(cb));
+  float dir_x = ld - lb;
+  len_x       = saturate(abs(dir_x) / max(len_x, 1e-5));
+  dir.x += dir_x * w;
+  len += len_x * len_x * w;
+
+  float ec    = le - lc;
+  float ca    = lc - la;
+  float len_y = max(abs(ec), abs(ca));
+  float dir_y = le - la;
+  len_y       = saturate(abs(dir_y) / max(len_y, 1e-5));
+  dir.y += dir_y * w;
+  len += len_y * len_y * w;
+}
+
+void easu_tap(
+    inout float3 color,
+    inout float  weight,
+    float2       offset,
+    float2       dir,
+    float2       len,
+    float        lobe,
+    float        clip,
+    float3       c) {
+  float2 v = float2(offset.x * dir.x + offset.y * dir.y, offset.x * -dir.y + offset.y * dir.x);
+  v *= len;
+  float d2 = min(dot(v, v), clip);
+
+  // Lanczos-2 approximated as (25/16 * (2/5 * x^2 - 1)^2 - (25/16 - 1)) * (lobe * x^2 - 1)^2.
+  float wb = 2.0 / 5.0 * d2 - 1.0;
+  float wa = lobe * d2 - 1.0;
+  wb *= wb;
+  wa *= wa;
+  wb = 25.0 / 16.0 * wb - (25.0 / 16.0 - 1.0);
+  float w = wb * wa;
+
+  color += c * w;
+  weight += w;
+}
+
+float4 main(float2 tex_coord : TEXCOORD0) : SV_Target {
+  float2 pos = float2(tex_coord.x, 1.0 - tex_coord.y) * source_size - 0.5;
+  float2 fp  = floor(pos);
+  float2 pp  = pos - fp;
+  int2   ip  = int2(fp);
+
+  // The 12 taps around the 2x2 quad f g j k:
+  //     b c
+  //   e f g h
+  //   i j k l
+  //     n o
+  float3 b = load_source(ip + int2(0, -1));
+  float3 c = load_source(ip + int2(1, -1));
+  float3 e = load_source(ip + int2(-1, 0));
+  float3 f = load_source(ip + int2(0, 0));
+  float3 g = load_source(ip + int2(1, 0));
+  float3 h = load_source(ip + int2(2, 0));
+  float3 i = load_source(ip + int2(-1, 1));
+  float3 j = load_source(ip + int2(0, 1));
+  float3 k = load_source(ip + int2(1, 1));
+  float3 l = load_source(ip + int2(2, 1));
+  float3 n = load_source(ip + int2(0, 2));
+  float3 o = load_source(ip + int2(1, 2));
+
+  float bl = upscale_luma(b);
+  float cl = upscale_luma(c);
+  float el = upscale_luma(e);
+  float fl = upscale_luma(f);
+  float gl = upscale_luma(g);
+  float hl = upscale_luma(h);
+  float il = upscale_luma(i);
+  float jl = upscale_luma(j);
+  float kl = upscale_luma(k);
+  float ll = upscale_luma(l);
+  float nl = upscale_luma(n);
+  float ol = upscale_luma(o);
+
+  float2 dir = float2(0.0, 0.0);
+  float  len = 0.0;
+  easu_set(dir, len, (1.0 - pp.x) * (1.0 - pp.y), bl, el, fl, gl, jl);
+  easu_set(dir, len, pp.x * (1.0 - pp.y), cl, fl, gl, hl, kl);
+  easu_set(dir, len, (1.0 - pp.x) * pp.y, fl, il, jl, kl, nl);
+  easu_set(dir, len, pp.x * pp.y, gl, jl, kl, ll, ol);
+
+  // Normalise the direction, falling back to the x axis where there is no gradient.
+  float dir_r = dot(dir, dir);
+  bool  zero  = dir_r < 1.0 / 32768.0;
+  dir         = zero ? float2(1.0, 0.0) : dir * rsqrt(dir_r);
+
+  // Edges stretch the kernel along them (up to sqrt(2) on diagonals) and shrink it across them.
+  len            = len * 0.5;
+  len            = len * len;
+  float  stretch = dot(dir, dir) / max(abs(dir.x), abs(dir.y));
+  float2 len2    = float2(1.0 + (stretch - 1.0) * len, 1.0 - 0.5 * len);
+  float  lobe    = 0.5 + ((1.0 / 4.0 - 0.04) - 0.5) * len;
+  float  clip    = 1.0 / lobe;
+
+  float3 color  = float3(0.0, 0.0, 0.0);
+  float  weight = 0.0;
+  easu_tap(color, weight, float2(0.0, -1.0) - pp, dir, len2, lobe, clip, b);
+  easu_tap(color, weight, float2(1.0, -1.0) - pp, dir, len2, lobe, clip, c);
+  easu_tap(color, weight, float2(-1.0, 1.0) - pp, dir, len2, lobe, clip, i);
+  easu_tap(color, weight, float2(0.0, 1.0) - pp, dir, len2, lobe, clip, j);
+  easu_tap(color, weight, float2(0.0, 0.0) - pp, dir, len2, lobe, clip, f);
+  easu_tap(color, weight, float2(-1.0, 0.0) - pp, dir, len2, lobe, clip, e);
+  easu_tap(color, weight, float2(1.0, 1.0) - pp, dir, len2, lobe, clip, k);
+  easu_tap(color, weight, float2(2.0, 1.0) - pp, dir, len2, lobe, clip, l);
+  easu_tap(color, weight, float2(2.0, 0.0) - pp, dir, len2, lobe, clip, h);
+  easu_tap(color, weight, float2(1.0, 0.0) - pp, dir, len2, lobe, clip, g);
+  easu_tap(color, weight, float2(1.0, 2.0) - pp, dir, len2, lobe, clip, o);
+  easu_tap(color, weight, float2(0.0, 2.0) - pp, dir, len2, lobe, clip, n);
+
+  float3 min4 = min(min(f, g), min(j, k));
+  float3 max4 = max(max(f, g), max(j, k));
+  color       = min(max4, max(min4, color / weight));
+
+  return float4(color, 1.0);
+}
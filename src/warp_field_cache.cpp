@@ -0,0 +1,183 @@
+// -- Warp Field Cache --------------------------------------------------------
+//
+// Amortises the warp field of fbm_warp_cached over frames. The field only depends on the shader
+// time (given the render size and the field mode) and changes slowly with it, so rather than being
+// rendered every frame it is rendered for keyframe times and interpolated between them. A frame
+// between keyframes a and b blends their fields, while the field of keyframe c, an interval after
+// b, is rendered a band at a time, so that it is finished by the time the frame time reaches b and
+// c takes over from b. The interval is a number of frames, lengthened when the frame time (without
+// waiting for the display) is over the budget and shortened when there is headroom.
+//
+// Anything else that changes the field (a resize, a reloaded shader) has to invalidate the cache,
+// after which the next frame renders keyframes a and b in full.
+
+static constexpr int WARP_FIELD_CACHE_TEXTURES_COUNT = 3;
+static constexpr int WARP_FIELD_CACHE_BANDS_COUNT    = 8;
+static constexpr int WARP_FIELD_CACHE_MIN_INTERVAL   = 2;  // Frames.
+static constexpr int WARP_FIELD_CACHE_MAX_INTERVAL   = 8;
+
+// Of the shader time step, which unlike the frame time isn't smoothed by dynamic resolution.
+static constexpr double WARP_FIELD_CACHE_STEP_SMOOTHING = 0.1;
+
+// Renders the bands [first_band, bands_end) of the field of one of the textures, at a time.
+struct Warp_Field_Render {
+  int    texture;
+  double time;
+  int    first_band;
+  int    bands_end;
+};
+
+// What a frame renders, followed by the two textures it samples and how far to blend between them.
+struct Warp_Field_Frame {
+  // At most finishing keyframe c, then when that was too late starting over with a and b in full.
+  std::array<Warp_Field_Render, 3> renders;
+  int                              renders_count;
+  int                              texture0;
+  int                              texture1;
+  float                            blend;
+};
+
+struct Warp_Field_Cache {
+  bool enabled;
+  int  interval_frames = (WARP_FIELD_CACHE_MIN_INTERVAL + WARP_FIELD_CACHE_MAX_INTERVAL) / 2;
+
+  // Created by the renderer, at texture_size. Only the first one is used when disabled.
+  std::array<SDL_GPUTexture*, WARP_FIELD_CACHE_TEXTURES_COUNT> textures;
+  HMM_Vec2                                                     texture_size;
+
+  // The keyframe time of each texture. Keyframe a is in the first texture, b and c follow it.
+  bool                                                valid;
+  std::array<double, WARP_FIELD_CACHE_TEXTURES_COUNT> times;
+  int                                                 first;
+  int                                                 bands_done;  // Of keyframe c.
+
+  // What the keyframes were rendered for, and the smoothed step of the shader time.
+  HMM_Vec2 field_size;
+  int      mode_index;
+  double   last_time;
+  double   smoothed_step;
+};
+
+static void warp_field_cache_invalidate(Warp_Field_Cache* cache) {
+  SDL_assert(cache != nullptr);
+
+  cache->valid = false;
+}
+
+// The GPU must be idle.
+static void warp_field_cache_destroy(Warp_Field_Cache* cache, SDL_GPUDevice* device) {
+  SDL_assert(cache != nullptr);
+  SDL_assert(device != nullptr);
+
+  for (auto& texture : cache->textures) {
+    SDL_ReleaseGPUTexture(device, texture);
+    texture = nullptr;
+  }
+  warp_field_cache_invalidate(cache);
+}
+
+// Renders the bands of the texture from first_band on.
+static void warp_field_frame_push(
+    Warp_Field_Frame* frame,
+    int               texture,
+    double            time,
+    int               first_band) {
+  frame->renders[frame->renders_count] = {texture, time, first_band, WARP_FIELD_CACHE_BANDS_COUNT};
+  frame->renders_count += 1;
+}
+
+// Lengthens the interval when the smoothed frame time is over the budget, and shortens it when
+// there is headroom, with the same band as dynamic resolution. Does nothing without a frame time,
+// e.g. when benchmarking.
+static void warp_field_cache_adapt(Warp_Field_Cache* cache, float budget_ms, float frame_ms) {
+  if (budget_ms <= 0.0f || frame_ms <= 0.0f) { return; }
+
+  if (frame_ms > budget_ms * DYNAMIC_RESOLUTION_UPPER_BAND) {
+    cache->interval_frames = SDL_min(cache->interval_frames + 1, WARP_FIELD_CACHE_MAX_INTERVAL);
+  } else if (frame_ms < budget_ms * DYNAMIC_RESOLUTION_LOWER_BAND) {
+    cache->interval_frames = SDL_max(cache->interval_frames - 1, WARP_FIELD_CACHE_MIN_INTERVAL);
+  }
+}
+
+// Plans the field of the frame at the time. When disabled, the frame renders the whole field into
+// the first texture.
+static Warp_Field_Frame warp_field_cache_update(
+    Warp_Field_Cache* cache,
+    double            time,
+    HMM_Vec2          field_size,
+    int               mode_index,
+    float             budget_ms,
+    float             frame_ms) {
+  SDL_assert(cache != nullptr);
+
+  Warp_Field_Frame frame = {};
+  if (!cache->enabled) {
+    cache->valid = false;
+    warp_field_frame_push(&frame, 0, time, 0);
+    return frame;
+  }
+
+  auto step = time - cache->last_time;
+  if (step > 0.0 && step < 1.0) {
+    if (cache->smoothed_step <= 0.0) { cache->smoothed_step = step; }
+    cache->smoothed_step += (step - cache->smoothed_step) * WARP_FIELD_CACHE_STEP_SMOOTHING;
+  }
+  cache->last_time = time;
+  auto interval    = SDL_max(cache->interval_frames * cache->smoothed_step, 1e-4);
+
+  if (field_size.X != cache->field_size.X || field_size.Y != cache->field_size.Y ||
+      mode_index != cache->mode_index) {
+    cache->valid      = false;
+    cache->field_size = field_size;
+    cache->mode_index = mode_index;
+  }
+
+  auto a = cache->first;
+  auto b = (a + 1) % WARP_FIELD_CACHE_TEXTURES_COUNT;
+  auto c = (a + 2) % WARP_FIELD_CACHE_TEXTURES_COUNT;
+  if (cache->valid && time >= cache->times[b]) {
+    if (cache->bands_done < WARP_FIELD_CACHE_BANDS_COUNT) {
+      warp_field_frame_push(&frame, c, cache->times[c], cache->bands_done);
+    }
+    warp_field_cache_adapt(cache, budget_ms, frame_ms);
+
+    // Keyframe a is done with, its texture takes the keyframe after the new c.
+    auto done          = a;
+    cache->first       = b;
+    cache->times[done] = cache->times[c] + interval;
+    cache->bands_done  = 0;
+    a                  = b;
+    b                  = c;
+    c                  = done;
+  }
+  // Also covers time going backwards, e.g. at the start of a benchmark case, and a frame that took
+  // longer than an interval.
+  if (!cache->valid || time < cache->times[a] || time >= cache->times[b]) {
+    frame.renders_count = 0;
+    cache->times[a]     = time;
+    cache->times[b]     = time + interval;
+    cache->times[c]     = time + interval * 2.0;
+    cache->bands_done   = 0;
+    cache->valid        = true;
+    warp_field_frame_push(&frame, a, cache->times[a], 0);
+    warp_field_frame_push(&frame, b, cache->times[b], 0);
+  }
+
+  // Enough bands of keyframe c that, going by the smoothed step, it will be finished by the frame
+  // that reaches keyframe b.
+  auto span        = cache->times[b] - cache->times[a];
+  auto next        = (time + cache->smoothed_step - cache->times[a]) / span;
+  auto bands_count = static_cast<int>(SDL_ceil(next * WARP_FIELD_CACHE_BANDS_COUNT));
+  bands_count      = SDL_clamp(bands_count, 0, WARP_FIELD_CACHE_BANDS_COUNT);
+  if (bands_count > cache->bands_done) {
+    frame.renders[frame.renders_count] = {c, cache->times[c], cache->bands_done, bands_count};
+    frame.renders_count += 1;
+    cache->bands_done = bands_count;
+  }
+
+  frame.texture0 = a;
+  frame.texture1 = b;
+  frame.blend    = static_cast<float>(SDL_clamp((time - cache->times[a]) / span, 0.0, 1.0));
+
+  return frame;
+}